@@ -7,41 +7,77 @@
 */
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <algorithm>
+#include <cstdint>
 #include "ballot.h"
+#include "csv_reader.h"
 
-Ballot::Ballot(std::vector<std::string> bstr, int bid) {
+Ballot::Ballot(std::vector<std::string> bstr, int bid)
+	: Ballot(std::vector<std::string_view>(bstr.begin(), bstr.end()), bid) {}
+
+Ballot::Ballot(const std::vector<std::string_view>& bstr, int bid)
+	: Ballot(ParseRanks(bstr), bid) {}
+
+Ballot::Ballot(const std::vector<uint16_t>& ranks, int bid) {
 	// Assign ID
 	id = bid;
 
 	// Assign choices
-	bool end_of_ballot = false;
-	for (int i = 1; !end_of_ballot; i++) {
-		// Search for entry "i" in bstr
-		auto iterator = std::find(bstr.begin(), bstr.end(), std::to_string(i));
-		// If entry "i" is found
-		if (iterator != bstr.end()) {
-			// Then push the corresponding candidate index
-			// onto position i-1 of the choices vector
-			int cand_idx = iterator - bstr.begin();
-			choices.push_back(cand_idx);
+	rank_status = RanksToChoices(ranks, choices);
+}
+
+Ballot::Ballot(const uint16_t* first_choice, int n, int bid)
+	: choices(first_choice, first_choice + n), id(bid) {}
+
+Ballot::Ballot(BallotStore* store, int index)
+	: store(store), index(index), id(index) {}
+
+Ballot::RankStatus Ballot::RanksToChoices(const std::vector<uint16_t>& ranks, std::vector<uint16_t>& choices) {
+	const uint16_t kUnranked = UINT16_MAX;
+	int n = (int) ranks.size();
+
+	// Record the candidate holding each rank, so choices[r] is the candidate ranked r
+	choices.assign(n + 1, kUnranked);
+	int total_ranked = 0;
+	bool duplicate = false;
+	for (int i = 0; i < n; i++) {
+		int rank = ranks[i];
+		if (rank == 0) {
+			continue;
+		}
+		total_ranked++;
+		// A rank beyond the number of candidates can never be reached
+		if (rank > n) {
+			continue;
+		}
+		if (choices[rank] != kUnranked) {
+			duplicate = true;
 		} else {
-			// Otherwise, indicate that the end of the ballot has been reached
-			end_of_ballot = true;
+			choices[rank] = (uint16_t) i;
 		}
 	}
-	total_choices = (int) choices.size();
+
+	// Shift ranks 1, 2, ... down into place, up to the first rank that is missing
+	int total_choices = 0;
+	while (total_choices < n && choices[total_choices + 1] != kUnranked) {
+		choices[total_choices] = choices[total_choices + 1];
+		total_choices++;
+	}
+	choices.resize(total_choices);
+
+	if (duplicate) {
+		return kRanksDuplicate;
+	}
+	return (total_choices < total_ranked) ? kRanksSkipped : kRanksValid;
 }
 
-int Ballot::GetChoice() {
-	// If the rank is lower than the number of preferred candidates
-	if (rank < (int) choices.size()) {
-		// Then return current preferred candidate
-		return choices[rank];
-	} else {
-		// Otherwise, return -1, indicating that
-		// there are no more preferred candidates
-		return -1;
+std::vector<uint16_t> Ballot::ParseRanks(const std::vector<std::string_view>& bstr) {
+	std::vector<uint16_t> ranks;
+	ranks.reserve(bstr.size());
+	for (std::string_view field : bstr) {
+		int rank = CsvReader::ToInt(field);
+		ranks.push_back((rank < 0 || rank > UINT16_MAX) ? 0 : (uint16_t) rank);
 	}
+	return ranks;
 }
@@ -10,12 +10,18 @@
 #define SRC_BALLOT_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint>
+#include "ballot_store.h"
 
 /**
 	@brief Class that represents a ballot.
 
 	A ballot has an ID number and an order of preferred candidates.
+	A Ballot is either a view of one ballot in a BallotStore, or, when
+	made with a constructor that takes a ballot's contents, holds its own
+	choices, rank and validity.
 */
 class Ballot {
 public:
@@ -28,21 +34,115 @@ public:
 	*/
 	Ballot(std::vector<std::string> bstr, int bid=-1);
 
+	/**
+		@brief Ballot's constructor from fields read in place.
+
+		@param bstr A vector of views that represents the order of preferred candidates.
+
+		@param bid The ID number to be assigned to the ballot.
+	*/
+	Ballot(const std::vector<std::string_view>& bstr, int bid=-1);
+
+	/**
+		@brief Ballot's constructor from decoded ranks.
+
+		@param ranks The rank given to each candidate, or `0` if the
+		candidate is not ranked.
+
+		@param bid The ID number to be assigned to the ballot.
+	*/
+	Ballot(const std::vector<uint16_t>& ranks, int bid=-1);
+
+	/**
+		@brief Ballot's constructor from its choices.
+
+		@param first_choice The candidate index of each choice on the ballot,
+		in order of preference.
+
+		@param n The number of choices on the ballot.
+
+		@param bid The ID number to be assigned to the ballot.
+	*/
+	Ballot(const uint16_t* first_choice, int n, int bid=-1);
+
+	/**
+		@brief Ballot's constructor as a view of a ballot in a store.
+
+		@param store The store holding the ballot.
+
+		@param index The index of the ballot in the store, which is also its ID number.
+	*/
+	Ballot(BallotStore* store, int index);
+
+	/// The result of checking the ranks on a ballot.
+	enum RankStatus {
+		/// The ranks run from 1 without gaps or repeats.
+		kRanksValid,
+		/// A rank is given to more than one candidate; the first one is kept.
+		kRanksDuplicate,
+		/// A rank is missing, so the ranks after it are not counted.
+		kRanksSkipped
+	};
+
+	/**
+		@brief Convert the ranks on a ballot into its choices.
+
+		Works in one pass over the ranks by recording the candidate that holds
+		each rank, so the cost is linear in the number of candidates.
+
+		@param ranks The rank given to each candidate, or `0` if the
+		candidate is not ranked.
+
+		@param choices Filled with the candidate index of each choice, in
+		order of preference, up to the first rank that is missing.
+
+		@return Whether the ranks were valid, repeated a rank or skipped one.
+		A repeated rank is reported over a skipped one.
+	*/
+	static RankStatus RanksToChoices(const std::vector<uint16_t>& ranks, std::vector<uint16_t>& choices);
+
+	/**
+		@brief Decode the fields of a ballot row into ranks.
+
+		@param bstr The fields of a ballot row.
+
+		@return The rank in each field, or `0` if the field is blank or
+		not a rank.
+	*/
+	static std::vector<uint16_t> ParseRanks(const std::vector<std::string_view>& bstr);
+
 	/**
 		@brief Return the ballot's current preferred candidate.
 		Return `-1` if there are no more preferred candidates.
 	*/
-	int GetChoice();
+	int GetChoice() {
+		if (store != nullptr) {
+			return store->GetChoice(index);
+		}
+		return (rank < (int) choices.size()) ? choices[rank] : -1;
+	}
 
 	/**
 		@brief Increment the rank of the ballot, choosing its next preferred candidate.
 	*/
-	void IncrementRank() { rank++; }
+	void IncrementRank() {
+		if (store != nullptr) {
+			store->IncrementRank(index);
+		} else {
+			rank++;
+		}
+	}
 
 	/**
 		@brief Set the ballot to be invalid.
 	*/
-	void SetInvalid() { valid = false; }
+	void SetInvalid() {
+		if (store != nullptr) {
+			store->SetInvalid(index);
+		} else {
+			valid = false;
+		}
+	}
 
 	/**
 		@brief Return the ID number of the ballot.
@@ -52,28 +152,40 @@ public:
 	/**
 		@brief Return total number of choices specified on the ballot.
 	*/
-	int get_total_choices() { return total_choices; }
+	int get_total_choices() { return (store != nullptr) ? store->get_total_choices(index) : (int) choices.size(); }
 
 	/**
 		@brief Return the validity of the ballot.
 	*/
-	bool get_valid() { return valid; }
+	bool get_valid() { return (store != nullptr) ? store->get_valid(index) : valid; }
+
+	/**
+		@brief Return whether the ranks the ballot was made from were valid,
+		repeated a rank or skipped one.
+	*/
+	RankStatus get_rank_status() { return rank_status; }
 
 private:
-	/// The ID number of the ballot.
-	int id;
+	/// The store holding the ballot, or null if the ballot holds its own choices.
+	BallotStore* store{nullptr};
 
-	/// The total number of choices specified on the ballot.
-	int total_choices;
+	/// The index of the ballot in the store.
+	int index{0};
 
-	/// A vector of integers that represents the order of preferred candidates.
-	std::vector<int> choices;
+	/// The candidate index of each choice, when the ballot is not in a store.
+	std::vector<uint16_t> choices;
 
-	/// The index indicating the ballot's current preferred candidate.
+	/// The index of the current preferred candidate, when the ballot is not in a store.
 	int rank{0};
 
-	/// The validity of the ballot; ballot must be removed from the election if invalid.
+	/// The validity of the ballot, when it is not in a store.
 	bool valid{true};
+
+	/// The ID number of the ballot.
+	int id;
+
+	/// Whether the ranks the ballot was made from were valid, repeated a rank or skipped one.
+	RankStatus rank_status{kRanksValid};
 };
 
 #endif
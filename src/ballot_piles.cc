@@ -0,0 +1,23 @@
+/**
+	@file ballot_piles.cc
+
+	Implementation of the methods for the BallotPiles class
+*/
+
+#include <vector>
+#include <cstdint>
+#include "ballot_piles.h"
+
+void BallotPiles::Add(int c, int id, const uint16_t* rest, int n) {
+	std::vector<uint16_t>& pile = piles[c];
+	pile.push_back((uint16_t) ((uint32_t) id & 0xFFFF));
+	pile.push_back((uint16_t) ((uint32_t) id >> 16));
+	pile.push_back((uint16_t) n);
+	pile.insert(pile.end(), rest, rest + n);
+}
+
+std::vector<uint16_t> BallotPiles::Take(int c) {
+	std::vector<uint16_t> pile;
+	pile.swap(piles[c]);
+	return pile;
+}
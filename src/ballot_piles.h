@@ -0,0 +1,103 @@
+/**
+	@file ballot_piles.h
+
+	Header file for the BallotPiles class
+*/
+
+#ifndef SRC_BALLOT_PILES_H
+#define SRC_BALLOT_PILES_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+	@brief Class that keeps each candidate's ballots together in one contiguous pile.
+
+	A pile is a sequence of records, one per ballot, each holding the
+	ballot's ID followed by the choices that come after the candidate the
+	ballot is assigned to:
+
+		[ID low 16 bits] [ID high 16 bits] [n] [choice 1] ... [choice n]
+
+	Redistributing a candidate's ballots is then a sequential scan over
+	its pile that appends each record, shortened by the choices passed
+	over, to the end of another pile. This moves more bytes than a list of
+	ballot IDs, but never touches the ballot store, which pays off only
+	when each ballot has many choices to pass over.
+*/
+class BallotPiles {
+public:
+	/**
+		@brief BallotPiles's constructor.
+
+		@param total_candidates The number of candidates, each of which has a pile.
+	*/
+	BallotPiles(int total_candidates=0) : piles(total_candidates) {}
+
+	/**
+		@brief Add a ballot to a candidate's pile.
+
+		@param c The index of the candidate the ballot is assigned to.
+
+		@param id The ID of the ballot.
+
+		@param rest The choices after `c` on the ballot, in order of preference.
+
+		@param n The number of choices in `rest`.
+	*/
+	void Add(int c, int id, const uint16_t* rest, int n);
+
+	/**
+		@brief Take a candidate's pile, leaving the candidate with an empty
+		pile that holds no memory.
+
+		@param c The index of the candidate.
+	*/
+	std::vector<uint16_t> Take(int c);
+
+	/**
+		@brief Read the next record of a pile.
+
+		@param pile The pile.
+
+		@param pos The position of the record, advanced to the next record.
+
+		@param id Set to the ID of the ballot.
+
+		@param rest Set to the choices after the candidate the ballot was assigned to.
+
+		@param n Set to the number of choices in `rest`.
+
+		@return `false` if there are no more records.
+	*/
+	static bool Read(const std::vector<uint16_t>& pile, std::size_t& pos, int& id, const uint16_t*& rest, int& n) {
+		if (pos + kRecordHeader > pile.size()) {
+			return false;
+		}
+		id = (int) (pile[pos] | ((uint32_t) pile[pos + 1] << 16));
+		n = pile[pos + 2];
+		rest = pile.data() + pos + kRecordHeader;
+		pos += kRecordHeader + n;
+		return true;
+	}
+
+	/**
+		@brief Return the number of bytes in a record with n choices.
+	*/
+	static std::size_t RecordBytes(int n) { return (kRecordHeader + n) * sizeof(uint16_t); }
+
+	/**
+		@brief Return the number of bytes in a candidate's pile.
+	*/
+	std::size_t get_pile_bytes(int c) { return piles[c].size() * sizeof(uint16_t); }
+
+private:
+	/// The number of 16-bit words before the choices of a record.
+	static const int kRecordHeader = 3;
+
+	/// The pile of each candidate.
+	std::vector<std::vector<uint16_t>> piles;
+};
+
+#endif
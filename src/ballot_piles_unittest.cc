@@ -0,0 +1,37 @@
+/**
+	@file ballot_piles_unittest.cc
+
+	Unit test for the BallotPiles class
+*/
+
+#include <vector>
+#include <cstdint>
+#include "gtest/gtest.h"
+#include "ballot_piles.h"
+
+/// Test that records are read back from a pile in the order they were added.
+TEST(BallotPilesTest, BallotPilesAddTake) {
+	BallotPiles piles(3);
+	std::vector<uint16_t> rest{2, 0};
+	piles.Add(1, 7, rest.data(), 2);
+	piles.Add(1, 100000, nullptr, 0);
+	piles.Add(0, 3, rest.data() + 1, 1);
+	EXPECT_EQ(piles.get_pile_bytes(1), BallotPiles::RecordBytes(2) + BallotPiles::RecordBytes(0));
+
+	std::vector<uint16_t> pile = piles.Take(1);
+	EXPECT_EQ(piles.get_pile_bytes(1), 0u);
+
+	std::size_t pos = 0;
+	int id;
+	const uint16_t* choices;
+	int n;
+	ASSERT_TRUE(BallotPiles::Read(pile, pos, id, choices, n));
+	EXPECT_EQ(id, 7);
+	ASSERT_EQ(n, 2);
+	EXPECT_EQ(choices[0], 2);
+	EXPECT_EQ(choices[1], 0);
+	ASSERT_TRUE(BallotPiles::Read(pile, pos, id, choices, n));
+	EXPECT_EQ(id, 100000);
+	EXPECT_EQ(n, 0);
+	EXPECT_FALSE(BallotPiles::Read(pile, pos, id, choices, n));
+}
@@ -0,0 +1,227 @@
+/**
+	@file ballot_store.cc
+
+	Implementation of the methods for the BallotStore class
+*/
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <algorithm>		// min, max
+#include "ballot_store.h"
+#include "parallel_for.h"
+
+namespace {
+
+/// The number of counts in a 64-byte cache line.
+const int kCacheLineInts = 64 / sizeof(int);
+
+}  // namespace
+
+BallotStore::BallotStore(int total_candidates) {
+	width = (total_candidates <= UINT8_MAX + 1) ? 1 : 2;
+}
+
+int BallotStore::Add(const std::vector<uint16_t>& choices) {
+	int id = total_ballots++;
+
+	uint64_t hash = 0;
+	std::size_t slot = 0;
+	if (deduplicate) {
+		// Add the ballot to its group if one exists
+		hash = Hash(choices);
+		slot = FindSlot(choices, hash);
+		if (slot < slots.size() && slots[slot] >= 0) {
+			int g = slots[slot];
+			weights[g]++;
+			if (!keep_ids) {
+				return g;
+			}
+			if (id_ranges[g].back().second == id - 1) {
+				id_ranges[g].back().second = id;
+			} else {
+				id_ranges[g].push_back({id, id});
+			}
+			return g;
+		}
+	}
+
+	if (width == 1) {
+		choices8.insert(choices8.end(), choices.begin(), choices.end());
+	} else {
+		choices16.insert(choices16.end(), choices.begin(), choices.end());
+	}
+	offsets.push_back(offsets.back() + choices.size());
+	ranks.push_back(0);
+	valid.push_back(1);
+	int i = size() - 1;
+
+	if (deduplicate) {
+		// Start a new group, growing the hash table to keep it at most half full
+		weights.push_back(1);
+		if (keep_ids) {
+			id_ranges.push_back({{id, id}});
+		}
+		hashes.push_back(hash);
+		if (2 * (std::size_t) size() > slots.size()) {
+			slots.assign(slots.empty() ? 64 : 2 * slots.size(), -1);
+			for (int g = 0; g < size(); g++) {
+				std::size_t s = hashes[g] & (slots.size() - 1);
+				while (slots[s] >= 0) {
+					s = (s + 1) & (slots.size() - 1);
+				}
+				slots[s] = g;
+			}
+		} else {
+			slots[slot] = i;
+		}
+	}
+	return i;
+}
+
+void BallotStore::Reserve(int n, std::size_t total_choices) {
+	if (width == 1) {
+		choices8.reserve(choices8.size() + total_choices);
+	} else {
+		choices16.reserve(choices16.size() + total_choices);
+	}
+	offsets.reserve(offsets.size() + n);
+	ranks.reserve(ranks.size() + n);
+	valid.reserve(valid.size() + n);
+}
+
+void BallotStore::Deduplicate(bool keep) {
+	if (deduplicate) {
+		if (!keep && keep_ids) {
+			keep_ids = false;
+			std::vector<std::vector<std::pair<int, int>>>().swap(id_ranges);
+		}
+		return;
+	}
+
+	// Add the ballots to a new store in order, so their IDs stay the same
+	BallotStore groups;
+	groups.width = width;
+	groups.deduplicate = true;
+	groups.keep_ids = keep;
+	std::vector<uint16_t> choices;
+	for (int i = 0; i < size(); i++) {
+		GetChoices(i, choices);
+		int g = groups.Add(choices);
+		if (!get_valid(i)) {
+			groups.SetInvalid(g);
+		}
+	}
+	*this = std::move(groups);
+}
+
+void BallotStore::CountChoices(std::vector<int>& counts, int threads) {
+	int n = size();
+	if (choices8.empty() && choices16.empty()) {
+		return;
+	}
+	threads = std::max(1, std::min(threads, n));
+
+	// each thread's histogram has a slot after the candidates' counts for the ballots that are
+	// not counted, and starts on its own cache line, so no two threads write to the same line
+	int none = (int) counts.size();
+	int stride = (none + kCacheLineInts) / kCacheLineInts * kCacheLineInts;
+	std::vector<int> histograms((std::size_t) stride * threads, 0);
+	ParallelFor(threads, [&](int t) {
+		int first = (int) ((long long) n * t / threads);
+		int last = (int) ((long long) n * (t + 1) / threads);
+		Count(first, last, histograms.data() + (std::size_t) stride * t, none);
+	});
+	for (int t = 0; t < threads; t++) {
+		for (int c = 0; c < (int) counts.size(); c++) {
+			counts[c] += histograms[(std::size_t) stride * t + c];
+		}
+	}
+}
+
+void BallotStore::Count(int first, int last, int* counts, int none) {
+	if (width == 1) {
+		Count(choices8, first, last, counts, none);
+	} else {
+		Count(choices16, first, last, counts, none);
+	}
+}
+
+template <typename Choice>
+void BallotStore::Count(const std::vector<Choice>& choices, int first, int last, int* counts, int none) {
+	const bool weighted = deduplicate;
+	for (int i = first; i < last; i++) {
+		// a ballot that is not counted still adds to a count, the one at `none`, so there is no branch
+		std::size_t position = offsets[i] + ranks[i];
+		bool counted = (valid[i] != 0) & (position < offsets[i + 1]);
+		int choice = choices[counted ? position : 0];
+		counts[counted ? choice : none] += weighted ? weights[i] : 1;
+	}
+}
+
+void BallotStore::GetChoices(int i, std::vector<uint16_t>& choices) {
+	if (width == 1) {
+		choices.assign(choices8.begin() + offsets[i], choices8.begin() + offsets[i + 1]);
+	} else {
+		choices.assign(choices16.begin() + offsets[i], choices16.begin() + offsets[i + 1]);
+	}
+}
+
+std::string BallotStore::FormatIds(int i) {
+	if (!deduplicate) {
+		return std::to_string(i);
+	}
+	if (!keep_ids) {
+		return "";
+	}
+	std::string ids;
+	for (const auto& range : id_ranges[i]) {
+		if (!ids.empty()) {
+			ids += ", ";
+		}
+		ids += std::to_string(range.first);
+		if (range.second != range.first) {
+			ids += "-" + std::to_string(range.second);
+		}
+	}
+	return ids;
+}
+
+std::size_t BallotStore::FindSlot(const std::vector<uint16_t>& choices, uint64_t hash) {
+	if (slots.empty()) {
+		return 0;
+	}
+	std::size_t mask = slots.size() - 1;
+	std::size_t slot = hash & mask;
+	while (slots[slot] >= 0 && (hashes[slots[slot]] != hash || !HasChoices(slots[slot], choices))) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+bool BallotStore::HasChoices(int i, const std::vector<uint16_t>& choices) {
+	if (get_total_choices(i) != (int) choices.size()) {
+		return false;
+	}
+	for (std::size_t k = 0; k < choices.size(); k++) {
+		std::size_t position = offsets[i] + k;
+		int choice = (width == 1) ? choices8[position] : choices16[position];
+		if (choice != choices[k]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint64_t BallotStore::Hash(const std::vector<uint16_t>& choices) {
+	// FNV-1a over the choices, mixed at the end so the low bits are usable
+	uint64_t hash = 14695981039346656037ULL;
+	for (uint16_t choice : choices) {
+		hash = (hash ^ choice) * 1099511628211ULL;
+	}
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	return hash;
+}
@@ -0,0 +1,283 @@
+/**
+	@file ballot_store.h
+
+	Header file for the BallotStore class
+*/
+
+#ifndef SRC_BALLOT_STORE_H
+#define SRC_BALLOT_STORE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+/**
+	@brief Class that stores all of the ballots of an election.
+
+	The choices of every ballot are kept in one contiguous array, with the
+	choices of ballot `i` between `offsets[i]` and `offsets[i+1]`. Choices
+	are stored in one byte when there are at most 256 candidates and in
+	two bytes otherwise. The rank each ballot is currently at and whether
+	it is valid are kept in arrays parallel to the offsets, so a ballot is
+	identified by its index alone and needs no allocation of its own.
+
+	In deduplicating mode, identical ballots are stored once as a group
+	with a weight and the ranges of ballot IDs it holds, so the cost of
+	counting is proportional to the number of distinct rankings rather
+	than to the number of voters.
+*/
+class BallotStore {
+public:
+	/**
+		@brief BallotStore's constructor.
+
+		@param total_candidates The number of candidates that ballots can choose.
+	*/
+	BallotStore(int total_candidates=0);
+
+	/**
+		@brief Add a ballot to the store.
+
+		@param choices The candidate index of each choice on the ballot,
+		in order of preference.
+
+		@return The index of the new ballot, or in deduplicating mode the
+		index of the group the ballot was added to. The ballot's ID is the
+		number of ballots added before it.
+	*/
+	int Add(const std::vector<uint16_t>& choices);
+
+	/**
+		@brief Set whether identical ballots are stored once as a group.
+
+		Has no effect once ballots have been added.
+	*/
+	void set_deduplicate(bool d) { if (ranks.empty()) deduplicate = d; }
+
+	/**
+		@brief Return whether identical ballots are stored once as a group.
+	*/
+	bool get_deduplicate() { return deduplicate; }
+
+	/**
+		@brief Group the ballots already in the store and switch to deduplicating mode.
+
+		Must be called before any ballot's rank is incremented.
+
+		@param keep_ids Whether each group keeps the IDs of its ballots. A
+		store that does not keep them uses memory proportional to the
+		number of distinct rankings only.
+	*/
+	void Deduplicate(bool keep_ids);
+
+	/**
+		@brief Copy the choices on the i-th entry of the store.
+
+		@param choices Filled with the candidate index of each choice.
+	*/
+	void GetChoices(int i, std::vector<uint16_t>& choices);
+
+	/**
+		@brief Return the number of ballots in the i-th entry of the store.
+	*/
+	int get_weight(int i) { return deduplicate ? weights[i] : 1; }
+
+	/**
+		@brief Return the IDs of the ballots in the i-th entry of the store.
+
+		@return The IDs as a comma-separated list of ranges, e.g. `"0-3, 7"`,
+		or an empty string if the IDs of grouped ballots are not kept.
+	*/
+	std::string FormatIds(int i);
+
+	/**
+		@brief Return the number of ballots added to the store.
+	*/
+	int get_total_ballots() { return total_ballots; }
+
+	/**
+		@brief Reserve space for ballots that are about to be added.
+
+		@param n The number of ballots.
+
+		@param total_choices The total number of choices on the ballots.
+	*/
+	void Reserve(int n, std::size_t total_choices);
+
+	/**
+		@brief Return the i-th ballot's current preferred candidate.
+		Return `-1` if there are no more preferred candidates.
+	*/
+	int GetChoice(int i) {
+		std::size_t position = offsets[i] + ranks[i];
+		if (position >= offsets[i + 1]) {
+			return -1;
+		}
+		return (width == 1) ? choices8[position] : choices16[position];
+	}
+
+	/**
+		@brief Add the number of ballots whose current preferred candidate
+		is each candidate to that candidate's count.
+
+		Invalid ballots and ballots with no more preferred candidates are
+		not counted. With several threads, each counts a contiguous range
+		of the ballots into a histogram of its own, and the histograms are
+		added together at the end.
+
+		@param counts The count of each candidate.
+
+		@param threads The number of threads to count on.
+	*/
+	void CountChoices(std::vector<int>& counts, int threads=1);
+
+	/**
+		@brief Increment the rank of the i-th ballot, choosing its next preferred candidate.
+	*/
+	void IncrementRank(int i) { ranks[i]++; }
+
+	/**
+		@brief Advance the i-th ballot to the next choice whose candidate is not eliminated.
+
+		The choice at the ballot's current rank is passed over, as are any
+		eliminated candidates after it, in a single call.
+
+		@param eliminated Whether each candidate is eliminated.
+
+		@return The ballot's new preferred candidate, or `-1` if there are no
+		more preferred candidates.
+	*/
+	int AdvanceChoice(int i, const std::vector<bool>& eliminated) {
+		return (width == 1) ? Advance(choices8, i, ranks[i] + 1, eliminated)
+			: Advance(choices16, i, ranks[i] + 1, eliminated);
+	}
+
+	/**
+		@brief Move the i-th ballot past any eliminated candidates at its current rank.
+
+		@param eliminated Whether each candidate is eliminated.
+
+		@return The ballot's preferred candidate, or `-1` if there are no
+		more preferred candidates.
+	*/
+	int SkipEliminated(int i, const std::vector<bool>& eliminated) {
+		return (width == 1) ? Advance(choices8, i, ranks[i], eliminated)
+			: Advance(choices16, i, ranks[i], eliminated);
+	}
+
+	/**
+		@brief Set the i-th ballot to be invalid.
+	*/
+	void SetInvalid(int i) { valid[i] = 0; }
+
+	/**
+		@brief Return the number of entries in the store; each entry is a
+		ballot, or in deduplicating mode a group of identical ballots.
+	*/
+	int size() { return (int) ranks.size(); }
+
+	/**
+		@brief Return the total number of choices specified on the i-th ballot.
+	*/
+	int get_total_choices(int i) { return (int) (offsets[i + 1] - offsets[i]); }
+
+	/**
+		@brief Return the validity of the i-th ballot.
+	*/
+	bool get_valid(int i) { return valid[i] != 0; }
+
+	/**
+		@brief Return the number of bytes used to store each choice.
+	*/
+	int get_width() { return width; }
+
+private:
+	/**
+		@brief Move the i-th ballot to the first choice from `rank` on whose
+		candidate is not eliminated.
+
+		@return The candidate at the new rank, or `-1` if there is none.
+	*/
+	template <typename Choice>
+	int Advance(const std::vector<Choice>& choices, int i, uint32_t rank, const std::vector<bool>& eliminated) {
+		std::size_t position = offsets[i] + rank;
+		std::size_t end = offsets[i + 1];
+		while (position < end && eliminated[choices[position]]) {
+			position++;
+		}
+		ranks[i] = (uint16_t) (position - offsets[i]);
+		return (position < end) ? (int) choices[position] : -1;
+	}
+
+	/**
+		@brief Add the weight of each ballot from first up to last to the
+		count of its current choice, or to `counts[none]` if it is invalid
+		or has no choice left.
+	*/
+	void Count(int first, int last, int* counts, int none);
+
+	/// Count the ballots from first up to last, reading choices of the store's width.
+	template <typename Choice>
+	void Count(const std::vector<Choice>& choices, int first, int last, int* counts, int none);
+
+	/**
+		@brief Find the group of ballots with the given choices.
+
+		@param choices The choices on a ballot.
+
+		@param hash The hash of the choices.
+
+		@return The slot in the hash table holding the group, or the
+		empty slot where it belongs.
+	*/
+	std::size_t FindSlot(const std::vector<uint16_t>& choices, uint64_t hash);
+
+	/// Return whether the i-th entry of the store has the given choices.
+	bool HasChoices(int i, const std::vector<uint16_t>& choices);
+
+	/// Return the hash of the choices on a ballot.
+	static uint64_t Hash(const std::vector<uint16_t>& choices);
+
+	/// The number of bytes used to store each choice.
+	int width;
+
+	/// Whether identical ballots are stored once as a group.
+	bool deduplicate{false};
+
+	/// Whether each group keeps the IDs of its ballots.
+	bool keep_ids{true};
+
+	/// The number of ballots added to the store.
+	int total_ballots{0};
+
+	/// The choices of all ballots when each choice fits in one byte.
+	std::vector<uint8_t> choices8;
+
+	/// The choices of all ballots when a choice needs two bytes.
+	std::vector<uint16_t> choices16;
+
+	/// The position in the choices array where each ballot starts, plus the end.
+	/// Wider than a ballot index, since an election can have more than 4G choices in all.
+	std::vector<std::size_t> offsets{0};
+
+	/// The index of each ballot's current preferred candidate.
+	std::vector<uint16_t> ranks;
+
+	/// The validity of each ballot; a ballot must be removed from the election if invalid.
+	std::vector<uint8_t> valid;
+
+	/// The number of ballots in each group, in deduplicating mode.
+	std::vector<int> weights;
+
+	/// The ranges of IDs of the ballots in each group, in deduplicating mode.
+	std::vector<std::vector<std::pair<int, int>>> id_ranges;
+
+	/// The hash of each group's choices, kept to grow the hash table.
+	std::vector<uint64_t> hashes;
+
+	/// Open-addressed hash table of group indices, `-1` if the slot is empty.
+	std::vector<int> slots;
+};
+
+#endif
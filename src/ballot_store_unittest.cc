@@ -0,0 +1,177 @@
+/**
+	@file ballot_store_unittest.cc
+
+	Unit test for the BallotStore class
+*/
+
+#include <vector>
+#include <cstdint>
+#include "gtest/gtest.h"
+#include "ballot_store.h"
+#include "ballot.h"
+
+/// Test fixture for testing the BallotStore class.
+class BallotStoreTest : public ::testing::Test {
+public:
+	/// Allocation of resources for test fixture.
+	void SetUp() {
+		for (const auto& choices : ballots) {
+			store.Add(choices);
+		}
+	}
+
+	/// The choices on each ballot.
+	std::vector<std::vector<uint16_t>> ballots{{0, 3, 1, 2}, {0, 2}, {}, {3}};
+
+	/// The store holding the ballots.
+	BallotStore store{4};
+};
+
+/// Test that the store walks each ballot's choices in order.
+TEST_F(BallotStoreTest, BallotStoreGetChoice) {
+	ASSERT_EQ(store.size(), 4);
+	EXPECT_EQ(store.get_width(), 1);
+	for (int i = 0; i < store.size(); i++) {
+		EXPECT_EQ(store.get_total_choices(i), (int) ballots[i].size());
+		for (uint16_t choice : ballots[i]) {
+			EXPECT_EQ(store.GetChoice(i), choice);
+			store.IncrementRank(i);
+		}
+		EXPECT_EQ(store.GetChoice(i), -1);
+	}
+}
+
+/// Test that invalidating a ballot does not affect the others.
+TEST_F(BallotStoreTest, BallotStoreSetInvalid) {
+	store.SetInvalid(2);
+	for (int i = 0; i < store.size(); i++) {
+		EXPECT_EQ(store.get_valid(i), i != 2);
+	}
+}
+
+/// Test that choices beyond one byte are stored in two bytes.
+TEST_F(BallotStoreTest, BallotStoreWideChoices) {
+	BallotStore wide(300);
+	EXPECT_EQ(wide.get_width(), 2);
+	wide.Add({299, 0, 256});
+	EXPECT_EQ(wide.GetChoice(0), 299);
+	wide.IncrementRank(0);
+	wide.IncrementRank(0);
+	EXPECT_EQ(wide.GetChoice(0), 256);
+}
+
+/// Test that a Ballot views a ballot in the store.
+TEST_F(BallotStoreTest, BallotStoreView) {
+	Ballot b(&store, 1);
+	EXPECT_EQ(b.get_id(), 1);
+	EXPECT_EQ(b.get_total_choices(), 2);
+	b.IncrementRank();
+	EXPECT_EQ(store.GetChoice(1), 2);
+	b.SetInvalid();
+	EXPECT_FALSE(store.get_valid(1));
+}
+
+/// Test that identical ballots are stored once as a group in deduplicating mode.
+TEST_F(BallotStoreTest, BallotStoreDeduplicate) {
+	BallotStore groups(4);
+	groups.set_deduplicate(true);
+	std::vector<std::vector<uint16_t>> added{{0, 1}, {0, 1}, {2}, {0, 1}, {0, 1, 3}, {0, 1}, {}, {2}};
+	std::vector<int> expected{0, 0, 1, 0, 2, 0, 3, 1};
+	for (int i = 0; i < (int) added.size(); i++) {
+		EXPECT_EQ(groups.Add(added[i]), expected[i]);
+	}
+	EXPECT_EQ(groups.size(), 4);
+	EXPECT_EQ(groups.get_total_ballots(), 8);
+	EXPECT_EQ(groups.get_weight(0), 4);
+	EXPECT_EQ(groups.get_weight(3), 1);
+	EXPECT_EQ(groups.FormatIds(0), "0-1, 3, 5");
+	EXPECT_EQ(groups.FormatIds(1), "2, 7");
+	EXPECT_EQ(groups.get_total_choices(2), 3);
+
+	// Many distinct groups grow the hash table
+	for (int i = 0; i < 1000; i++) {
+		groups.Add({(uint16_t) (i % 4), (uint16_t) (i / 4 % 4), (uint16_t) (i / 16)});
+	}
+	// Ballot 52 is {0, 1, 3}, which is already a group
+	EXPECT_EQ(groups.size(), 4 + 999);
+
+	// The mode cannot change once ballots have been added
+	store.set_deduplicate(true);
+	EXPECT_FALSE(store.get_deduplicate());
+}
+
+/// Test that grouping a store keeps each ballot's ID and validity.
+TEST_F(BallotStoreTest, BallotStoreRegroup) {
+	store.Add({0, 2});
+	store.SetInvalid(2);
+	store.Deduplicate(true);
+	EXPECT_TRUE(store.get_deduplicate());
+	EXPECT_EQ(store.size(), 4);
+	EXPECT_EQ(store.get_total_ballots(), 5);
+	EXPECT_EQ(store.FormatIds(1), "1, 4");
+	EXPECT_EQ(store.get_weight(1), 2);
+	EXPECT_FALSE(store.get_valid(2));
+
+	std::vector<uint16_t> choices;
+	store.GetChoices(0, choices);
+	EXPECT_EQ(choices, ballots[0]);
+
+	store.Deduplicate(false);
+	EXPECT_EQ(store.FormatIds(1), "");
+	EXPECT_EQ(store.Add({0, 2}), 1);
+	EXPECT_EQ(store.get_weight(1), 3);
+}
+
+/// Test that a ballot advances past every eliminated candidate in one call.
+TEST_F(BallotStoreTest, BallotStoreAdvanceChoice) {
+	std::vector<bool> eliminated{false, true, false, true};
+	// {0, 3, 1, 2} skips 3 and 1
+	EXPECT_EQ(store.AdvanceChoice(0, eliminated), 2);
+	EXPECT_EQ(store.GetChoice(0), 2);
+	EXPECT_EQ(store.AdvanceChoice(0, eliminated), -1);
+	EXPECT_EQ(store.GetChoice(0), -1);
+
+	// {3} has only an eliminated candidate
+	EXPECT_EQ(store.SkipEliminated(3, eliminated), -1);
+	// {0, 2} stays on a candidate that is not eliminated
+	EXPECT_EQ(store.SkipEliminated(1, eliminated), 0);
+	EXPECT_EQ(store.AdvanceChoice(1, eliminated), 2);
+
+	BallotStore wide(300);
+	wide.Add({299, 1, 0});
+	EXPECT_EQ(wide.AdvanceChoice(0, std::vector<bool>(300, true)), -1);
+}
+
+/// Test that each candidate is counted once for each ballot that currently prefers it.
+TEST_F(BallotStoreTest, BallotStoreCountChoices) {
+	store.SetInvalid(3);
+	store.IncrementRank(1);
+	std::vector<int> counts(4, 0);
+	store.CountChoices(counts);
+	EXPECT_EQ(counts, std::vector<int>({1, 0, 1, 0}));
+
+	// a group counts once for each of its ballots
+	BallotStore groups(3);
+	groups.set_deduplicate(true);
+	for (const std::vector<uint16_t>& choices : {std::vector<uint16_t>{1}, {2}, {1}}) {
+		groups.Add(choices);
+	}
+	counts.assign(3, 0);
+	groups.CountChoices(counts);
+	EXPECT_EQ(counts, std::vector<int>({0, 2, 1}));
+}
+
+/// Test that counting on several threads gives the same counts as on one.
+TEST(BallotStoreThreadsTest, BallotStoreCountChoicesThreads) {
+	BallotStore store(5);
+	for (int i = 0; i < 1000; i++) {
+		store.Add({(uint16_t) (i * i % 5)});
+	}
+	std::vector<int> expected(5, 0);
+	store.CountChoices(expected);
+	for (int threads = 2; threads <= 8; threads++) {
+		std::vector<int> counts(5, 0);
+		store.CountChoices(counts, threads);
+		EXPECT_EQ(counts, expected);
+	}
+}
@@ -8,6 +8,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include "gtest/gtest.h"
 #include "ballot.h"
 
@@ -104,3 +105,66 @@ TEST_F(BallotTest, BallotSetInvalid) {
 	EXPECT_TRUE(ballots[2]->get_valid());
 	EXPECT_FALSE(ballots[3]->get_valid());
 }
+
+/// Test that Ballot's constructor from ranks matches the one from strings.
+TEST_F(BallotTest, BallotFromRanks) {
+	std::vector<std::vector<uint16_t>> ranks{{1,3,4,2}, {1,0,2,0}, {1,2,3,0}, {0,0,0,1}};
+
+	for (int i = 0; i < (int) ranks.size(); i++) {
+		Ballot b(ranks[i], i);
+		EXPECT_EQ(b.get_total_choices(), ballots[i]->get_total_choices());
+		for (int r = 0; r <= b.get_total_choices(); r++) {
+			EXPECT_EQ(b.GetChoice(), ballots[i]->GetChoice());
+			b.IncrementRank();
+			ballots[i]->IncrementRank();
+		}
+	}
+}
+
+/// Test that Ballot's RanksToChoices reports repeated and skipped ranks.
+TEST_F(BallotTest, BallotRanksToChoicesStatus) {
+	std::vector<uint16_t> choices;
+
+	EXPECT_EQ(Ballot::RanksToChoices({2,0,1,3}, choices), Ballot::kRanksValid);
+	EXPECT_EQ(choices, std::vector<uint16_t>({2,0,3}));
+
+	// The first candidate given a repeated rank is kept
+	EXPECT_EQ(Ballot::RanksToChoices({1,2,2,3}, choices), Ballot::kRanksDuplicate);
+	EXPECT_EQ(choices, std::vector<uint16_t>({0,1,3}));
+
+	// Ranks after a missing rank are not counted
+	EXPECT_EQ(Ballot::RanksToChoices({1,3,0,4}, choices), Ballot::kRanksSkipped);
+	EXPECT_EQ(choices, std::vector<uint16_t>({0}));
+	EXPECT_EQ(Ballot::RanksToChoices({9,0,0}, choices), Ballot::kRanksSkipped);
+	EXPECT_TRUE(choices.empty());
+
+	EXPECT_EQ(Ballot::RanksToChoices({}, choices), Ballot::kRanksValid);
+	EXPECT_TRUE(choices.empty());
+
+	// A ballot made from ranks keeps their status
+	EXPECT_EQ(Ballot(std::vector<uint16_t>{1,2,2,3}).get_rank_status(), Ballot::kRanksDuplicate);
+	EXPECT_EQ(Ballot(std::vector<uint16_t>{2,0,1,3}).get_rank_status(), Ballot::kRanksValid);
+}
+
+/// Test that a ballot holding its own choices behaves the same as a view of the same ballot in a store.
+TEST_F(BallotTest, BallotStoreView) {
+	std::vector<uint16_t> choices{2, 0, 3};
+	BallotStore store(4);
+	store.Add(choices);
+	Ballot view(&store, 0);
+	Ballot own(choices.data(), (int) choices.size(), 0);
+
+	EXPECT_EQ(own.get_total_choices(), view.get_total_choices());
+	for (int r = 0; r <= (int) choices.size(); r++) {
+		EXPECT_EQ(own.GetChoice(), view.GetChoice());
+		own.IncrementRank();
+		view.IncrementRank();
+	}
+	EXPECT_EQ(own.GetChoice(), -1);
+
+	own.SetInvalid();
+	EXPECT_FALSE(own.get_valid());
+	EXPECT_TRUE(view.get_valid());
+	view.SetInvalid();
+	EXPECT_FALSE(store.get_valid(0));
+}
@@ -8,19 +8,24 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 #include "candidate.h"
 
-Candidate::Candidate(std::string n, std::string p) {
-	name = n;
-	party = p;
-}
+Candidate::Candidate(std::string n, std::string p) : name(std::move(n)), party(std::move(p)) {}
 
-void Candidate::AddBallotId(int bid) {
+void Candidate::AddBallotId(int bid, int weight) {
 	votes.push_back(bid);
-	total_votes++;
+	total_votes += weight;
+}
+
+void Candidate::AddBallotIds(const std::vector<int>& bids, int total_weight) {
+	votes.insert(votes.end(), bids.begin(), bids.end());
+	total_votes += total_weight;
 }
 
 std::vector<int> Candidate::RemoveVotes() {
 	total_votes = 0;
-	return votes;
+	std::vector<int> removed;
+	removed.swap(votes);
+	return removed;
 }
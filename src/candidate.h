@@ -11,6 +11,7 @@
 
 #include <string>
 #include <vector>
+#include <cstddef>
 
 /**
 	@brief Class that represents a candidate.
@@ -32,12 +33,27 @@ public:
 		@brief Distribute a Ballot to the candidate by storing the Ballot ID.
 
 		@param bid The ID of the Ballot to be distributed to the candidate.
+
+		@param weight The number of votes the Ballot counts for, which is more
+		than one for a group of identical ballots.
+	*/
+	void AddBallotId(int bid, int weight=1);
+
+	/**
+		@brief Distribute several Ballots to the candidate at once.
+
+		@param bids The IDs of the Ballots, in the order they are distributed.
+
+		@param total_weight The number of votes the Ballots count for together.
 	*/
-	void AddBallotId(int bid);
+	void AddBallotIds(const std::vector<int>& bids, int total_weight);
 
 	/**
 		@brief Remove all of the candidate's votes.
 
+		The Ballot IDs are handed over without copying, and the candidate
+		keeps no memory for them afterwards.
+
 		@return A vector of the candidate's Ballot IDs.
 	*/
 	std::vector<int> RemoveVotes();
@@ -45,18 +61,35 @@ public:
 	/**
 		@brief Return the name of the candidate.
 	*/
-	std::string get_name() { return name; }
+	const std::string& get_name() { return name; }
 
 	/**
 		@brief Return the party of the candidate.
 	*/
-	std::string get_party() { return party; }
+	const std::string& get_party() { return party; }
 
 	/**
 		@brief Return the candidate's total number of votes.
 	*/
 	int get_total_votes() { return total_votes; }
 
+	/**
+		@brief Set the candidate's total number of votes, for counts that
+		do not distribute Ballot IDs.
+	*/
+	void set_total_votes(int n) { total_votes = n; }
+
+	/**
+		@brief Add to the candidate's total number of votes, for counts that
+		do not distribute Ballot IDs.
+	*/
+	void AddVotes(int n) { total_votes += n; }
+
+	/**
+		@brief Return the number of bytes held to store the candidate's Ballot IDs.
+	*/
+	std::size_t get_bucket_bytes() { return votes.capacity() * sizeof(int); }
+
 private:
 	/// The name of the candidate.
 	std::string name;
@@ -57,6 +57,8 @@ TEST_F(CandidateTest, CandidateVotes) {
 
 	std::vector<int> votes = candidates[0]->RemoveVotes();
 	EXPECT_EQ(candidates[0]->get_total_votes(), 0);
+	EXPECT_EQ(candidates[0]->get_bucket_bytes(), 0u);
+	EXPECT_TRUE(candidates[0]->RemoveVotes().empty());
 
 	for (int i=0; i<n; i++) {
 		EXPECT_EQ(votes[i], i);
@@ -0,0 +1,161 @@
+/**
+	@file csv_reader.cc
+
+	Implementation of the methods for the CsvReader class
+*/
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstring>			// memchr
+#include <climits>			// INT_MAX
+#include <fcntl.h>			// open
+#include <unistd.h>			// close
+#include <sys/mman.h>		// mmap, munmap
+#include <sys/stat.h>		// fstat
+#include "csv_reader.h"
+
+namespace {
+
+/// Return whether c separates two fields.
+inline bool IsSeparator(char c) {
+	return c == ',' || c == ' ';
+}
+
+/// Return whether c is stripped from the edges of a field.
+inline bool IsBracket(char c) {
+	return c == '[' || c == ']' || c == '(' || c == ')';
+}
+
+}  // namespace
+
+CsvReader::CsvReader(std::string filename) {
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) {
+			madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+			length = st.st_size;
+			begin = static_cast<const char*>(mapping);
+			end = begin + length;
+			cursor = begin;
+		}
+	}
+	close(fd);
+}
+
+CsvReader::CsvReader(const char* first, const char* last) {
+	if (first != last) {
+		begin = first;
+		end = last;
+		cursor = begin;
+	}
+}
+
+CsvReader::~CsvReader() {
+	if (length > 0) {
+		munmap(const_cast<char*>(begin), length);
+	}
+}
+
+bool CsvReader::ReadLine(std::vector<std::string_view>& fields) {
+	fields.clear();
+	if (cursor == end) {
+		return false;
+	}
+
+	// Find the end of the line
+	const char* eol = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+	if (eol == nullptr) {
+		eol = end;
+	}
+
+	// An empty line has no fields
+	if (eol != cursor) {
+		const char* start = cursor;
+		for (const char* p = cursor; ; p++) {
+			if (p == eol || IsSeparator(*p)) {
+				// Strip brackets from both edges of the field
+				const char* first = start;
+				const char* last = p;
+				while (first < last && IsBracket(*first)) first++;
+				while (last > first && IsBracket(*(last - 1))) last--;
+				fields.emplace_back(first, last - first);
+
+				if (p == eol) {
+					break;
+				}
+				start = p + 1;
+			}
+		}
+	}
+
+	cursor = (eol == end) ? end : eol + 1;
+	return true;
+}
+
+bool CsvReader::SkipLine() {
+	if (cursor == end) {
+		return false;
+	}
+	const char* eol = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+	cursor = (eol == nullptr) ? end : eol + 1;
+	return true;
+}
+
+std::vector<std::string_view> CsvReader::SplitLines(std::string_view text, int n) {
+	std::vector<std::string_view> chunks;
+	if (n < 1) {
+		n = 1;
+	}
+
+	std::size_t start = 0;
+	for (int i = 1; i <= n; i++) {
+		std::size_t stop = text.size();
+		if (i < n) {
+			// Move the cut forward to just after the next newline
+			std::size_t cut = std::max(start, text.size() / n * i);
+			std::size_t eol = text.find('\n', cut);
+			stop = (eol == std::string_view::npos) ? text.size() : eol + 1;
+		}
+		chunks.push_back(text.substr(start, stop - start));
+		start = stop;
+	}
+	return chunks;
+}
+
+std::size_t CsvReader::CountLines(std::string_view text) {
+	if (text.empty()) {
+		return 0;
+	}
+	std::size_t lines = std::count(text.begin(), text.end(), '\n');
+	// The last line need not end with a newline
+	if (text.back() != '\n') {
+		lines++;
+	}
+	return lines;
+}
+
+int CsvReader::ToInt(std::string_view field) {
+	if (field.empty()) {
+		return -1;
+	}
+	int value = 0;
+	for (char c : field) {
+		if (c < '0' || c > '9') {
+			return -1;
+		}
+		// Reject values that do not fit in an int
+		if (value > (INT_MAX - 9) / 10) {
+			return -1;
+		}
+		value = value * 10 + (c - '0');
+	}
+	return value;
+}
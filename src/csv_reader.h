@@ -0,0 +1,135 @@
+/**
+	@file csv_reader.h
+
+	Header file for the CsvReader class
+*/
+
+#ifndef SRC_CSV_READER_H
+#define SRC_CSV_READER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+/**
+	@brief Class that reads a CSV ballot file without copying it.
+
+	The file is memory-mapped and scanned in place. Each line is split on
+	the same separators as the rest of the system (`,` and space, keeping
+	empty fields), and the fields are handed out as `std::string_view`s
+	into the mapping, so no heap allocation is made per field.
+*/
+class CsvReader {
+public:
+	/**
+		@brief CsvReader's constructor.
+
+		Map the file into memory. A file that cannot be opened or is empty
+		is treated as having no lines.
+
+		@param filename The name of the CSV file to read.
+	*/
+	CsvReader(std::string filename);
+
+	/**
+		@brief CsvReader's constructor for text that is already in memory.
+
+		@param first The start of the text to read.
+
+		@param last One past the end of the text to read.
+
+		The text is not copied and must outlive the reader.
+	*/
+	CsvReader(const char* first, const char* last);
+
+	/**
+		@brief CsvReader's destructor.
+
+		Unmap the file.
+	*/
+	~CsvReader();
+
+	CsvReader(const CsvReader&) = delete;
+	CsvReader& operator=(const CsvReader&) = delete;
+
+	/**
+		@brief Read the next line and split it into fields.
+
+		Bracket and parenthesis characters at the edges of a field are not
+		part of the returned view, i.e., `[Pike` and `(D)` are read as
+		`Pike` and `D`. The views stay valid for the lifetime of the reader.
+
+		@param fields Cleared, then filled with the fields of the line.
+
+		@return `false` if there are no more lines to read.
+	*/
+	bool ReadLine(std::vector<std::string_view>& fields);
+
+	/**
+		@brief Skip the next line.
+
+		@return `false` if there are no more lines to skip.
+	*/
+	bool SkipLine();
+
+	/**
+		@brief Split text into chunks that each hold whole lines.
+
+		Every chunk ends just after a newline unless it reaches the end of
+		the text, so the chunks
+		can be read independently and their lines concatenated in order
+		give the lines of `text`. Some chunks may be empty.
+
+		@param text The text to split.
+
+		@param n The number of chunks to split the text into.
+
+		@return The `n` chunks, in order.
+	*/
+	static std::vector<std::string_view> SplitLines(std::string_view text, int n);
+
+	/**
+		@brief Count the lines in a chunk of text.
+
+		@param text The text whose lines are to be counted.
+
+		@return The number of lines ReadLine would return for `text`.
+	*/
+	static std::size_t CountLines(std::string_view text);
+
+	/**
+		@brief Parse a field as a non-negative integer.
+
+		@param field The field to parse.
+
+		@return The value of the field, or `-1` if the field is empty or
+		is not made up only of digits.
+	*/
+	static int ToInt(std::string_view field);
+
+	/**
+		@brief Return whether the file was opened and has content.
+	*/
+	bool is_open() { return begin != nullptr; }
+
+	/**
+		@brief Return the part of the file that has not been read yet.
+	*/
+	std::string_view get_remaining() { return std::string_view(cursor, end - cursor); }
+
+private:
+	/// The start of the mapped file.
+	const char* begin{nullptr};
+
+	/// One past the end of the mapped file.
+	const char* end{nullptr};
+
+	/// The start of the next line to be read.
+	const char* cursor{nullptr};
+
+	/// The size of the mapping in bytes, or `0` if the text is not mapped.
+	std::size_t length{0};
+};
+
+#endif
@@ -0,0 +1,107 @@
+/**
+	@file csv_reader_unittest.cc
+
+	Unit test for the CsvReader class
+*/
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "gtest/gtest.h"
+#include "csv_reader.h"
+
+/// Test the functionality of CsvReader's ReadLine method.
+TEST(CsvReaderTest, CsvReaderReadLine) {
+	CsvReader csv("../testing/opl_testfile.csv");
+	std::vector<std::string_view> fields;
+
+	ASSERT_TRUE(csv.is_open());
+
+	ASSERT_TRUE(csv.ReadLine(fields));
+	ASSERT_EQ(fields.size(), 1u);
+	EXPECT_EQ(fields[0], "OPL");
+
+	ASSERT_TRUE(csv.SkipLine());
+
+	ASSERT_TRUE(csv.ReadLine(fields));
+	ASSERT_EQ(fields.size(), 12u);
+	EXPECT_EQ(fields[0], "Pike");
+	EXPECT_EQ(fields[1], "D");
+	EXPECT_EQ(fields[10], "Smith");
+	EXPECT_EQ(fields[11], "I");
+
+	ASSERT_TRUE(csv.SkipLine());
+	ASSERT_TRUE(csv.SkipLine());
+
+	ASSERT_TRUE(csv.ReadLine(fields));
+	ASSERT_EQ(fields.size(), 6u);
+	EXPECT_EQ(fields[0], "1");
+	for (int i = 1; i < 6; i++) {
+		EXPECT_EQ(fields[i], "");
+	}
+
+	int lines = 1;
+	while (csv.ReadLine(fields)) {
+		lines++;
+	}
+	EXPECT_EQ(lines, 9);
+	EXPECT_FALSE(csv.ReadLine(fields));
+	EXPECT_TRUE(fields.empty());
+}
+
+/// Test CsvReader on the IR candidate format and on a missing file.
+TEST(CsvReaderTest, CsvReaderCandidatesAndMissingFile) {
+	CsvReader csv("../testing/ir_testfile.csv");
+	std::vector<std::string_view> fields;
+
+	ASSERT_TRUE(csv.SkipLine());
+	ASSERT_TRUE(csv.SkipLine());
+	ASSERT_TRUE(csv.ReadLine(fields));
+	ASSERT_EQ(fields.size(), 8u);
+	EXPECT_EQ(fields[0], "Rosen");
+	EXPECT_EQ(fields[1], "D");
+	EXPECT_EQ(fields[6], "Royce");
+	EXPECT_EQ(fields[7], "L");
+
+	CsvReader missing("../testing/does_not_exist.csv");
+	EXPECT_FALSE(missing.is_open());
+	EXPECT_FALSE(missing.ReadLine(fields));
+}
+
+/// Test the functionality of CsvReader's ToInt method.
+TEST(CsvReaderTest, CsvReaderToInt) {
+	EXPECT_EQ(CsvReader::ToInt("0"), 0);
+	EXPECT_EQ(CsvReader::ToInt("7"), 7);
+	EXPECT_EQ(CsvReader::ToInt("1234"), 1234);
+	EXPECT_EQ(CsvReader::ToInt(""), -1);
+	EXPECT_EQ(CsvReader::ToInt("1a"), -1);
+	EXPECT_EQ(CsvReader::ToInt("-3"), -1);
+	EXPECT_EQ(CsvReader::ToInt("99999999999999"), -1);
+}
+
+/// Test the functionality of CsvReader's SplitLines and CountLines methods.
+TEST(CsvReaderTest, CsvReaderSplitLines) {
+	std::string text = "1,3,4,2\n1,,2,\n1,2,3,\n3,2,1,4\n,,1,2\n,,,1";
+
+	for (int n = 1; n <= 12; n++) {
+		std::vector<std::string_view> chunks = CsvReader::SplitLines(text, n);
+		ASSERT_EQ((int) chunks.size(), n);
+
+		std::string joined;
+		std::size_t lines = 0;
+		for (std::size_t i = 0; i < chunks.size(); i++) {
+			joined += chunks[i];
+			// Every chunk ends with a newline unless it reaches the end of the text
+			if (joined.size() < text.size() && !chunks[i].empty()) {
+				EXPECT_EQ(chunks[i].back(), '\n');
+			}
+			lines += CsvReader::CountLines(chunks[i]);
+		}
+		EXPECT_EQ(joined, text);
+		EXPECT_EQ(lines, 6u);
+	}
+
+	EXPECT_EQ(CsvReader::CountLines(""), 0u);
+	EXPECT_EQ(CsvReader::CountLines("\n"), 1u);
+	EXPECT_EQ(CsvReader::CountLines("1,2\n3,4\n"), 2u);
+}
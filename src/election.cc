@@ -7,11 +7,124 @@
 */
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
 #include <cstdlib>			// rand, srand
 #include <ctime>				// time
+#include <algorithm>		// min, max
+#include <thread>
 #include "election.h"
 
+namespace {
+
+/// The least number of ballots given to each thread when the number of
+/// threads is chosen automatically.
+const int kMinBallotsPerThread = 1 << 16;
+
+}  // namespace
+
+void Election::AddBallot(const std::vector<std::string_view>& row) {
+	AddBallot(Ballot::ParseRanks(row));
+}
+
+void Election::AddBallot(const std::vector<uint16_t>& ranks) {
+	Ballot::RankStatus status = Ballot::RanksToChoices(ranks, ballot_choices);
+	AddBallotChoices(ballot_choices, status);
+}
+
+void Election::AddBallotChoices(const std::vector<uint16_t>& choices, Ballot::RankStatus status) {
+	if (status != Ballot::kRanksValid) {
+		CheckRanks(status);
+	}
+	if (StreamsBallots()) {
+		// only the candidate ranked first is counted, and the ballot is not kept
+		if (!choices.empty() && choices[0] < total_candidates) {
+			first_choice_votes[choices[0]]++;
+		}
+		return;
+	}
+	CheckBallot(ballots.Add(choices));
+}
+
+void Election::CheckRanks(Ballot::RankStatus status) {
+	total_rank_errors++;
+	// The ballot about to be added takes the next ballot ID; count-only
+	// elections report the number of such ballots instead
+	if (audit_ballots && !count_only && logger != nullptr) {
+		std::string ballot = "Ballot " + std::to_string(ballots.get_total_ballots());
+		if (status == Ballot::kRanksDuplicate) {
+			logger->WriteToAuditFile(ballot + " gives the same rank to more than one candidate, so only the first of them is counted.\n");
+		} else {
+			logger->WriteToAuditFile(ballot + " skips a rank, so the choices after the gap are not counted.\n");
+		}
+	}
+}
+
+void Election::AuditRankErrors() {
+	if (total_rank_errors > 0 && (count_only || !audit_ballots)) {
+		logger->WriteToAuditFile(std::to_string(total_rank_errors) + " ballots give the same rank to more than one candidate or skip a rank.\n");
+	}
+}
+
+void Election::AddBallots(const std::vector<std::vector<std::string>>& data, int first_row) {
+	std::vector<std::string_view> row;
+	// Rows beyond the ballot count in the header are ignored
+	for (int i = 0; i < total_ballots && first_row + i < (int) data.size(); i++) {
+		row.assign(data[first_row + i].begin(), data[first_row + i].end());
+		AddBallot(row);
+	}
+}
+
+void Election::set_count_only(bool c) {
+	count_only = c;
+	if (StreamsBallots()) {
+		// count the ballots already added and let go of them
+		first_choice_votes.assign(total_candidates, 0);
+		ballots.CountChoices(first_choice_votes);
+		ballots = BallotStore(total_candidates);
+	} else if (count_only) {
+		ballots.Deduplicate(false);
+	}
+}
+
+void Election::CountFirstChoices(std::vector<int>& votes) {
+	if (StreamsBallots()) {
+		for (int c = 0; c < total_candidates; c++) {
+			votes[c] += first_choice_votes[c];
+		}
+	} else {
+		ballots.CountChoices(votes, ThreadsFor(ballots.size()));
+	}
+}
+
+std::string Election::BallotLabel(int b) {
+	if (!ballots.get_deduplicate()) {
+		return "Ballot " + std::to_string(b);
+	}
+	int weight = ballots.get_weight(b);
+	if (count_only) {
+		return "Ballot group " + std::to_string(b) + " (" + std::to_string(weight) + (weight == 1 ? " ballot)" : " ballots)");
+	}
+	std::string ids = (weight == 1) ? "ballot " : std::to_string(weight) + " ballots: ";
+	return "Ballot group " + std::to_string(b) + " (" + ids + ballots.FormatIds(b) + ")";
+}
+
+int Election::ThreadsFor(int n) {
+	int threads = num_threads;
+	if (threads <= 0) {
+		int max_threads = (int) std::max(1u, std::thread::hardware_concurrency());
+		threads = std::min(max_threads, n / kMinBallotsPerThread + 1);
+	}
+	return std::max(1, std::min(threads, n));
+}
+
 int Election::ResolveTie(int n) {
-	srand(time(nullptr));
+	// seeding once keeps ties resolved within the same second independent
+	static bool seeded = false;
+	if (!seeded) {
+		srand(time(nullptr));
+		seeded = true;
+	}
 	return rand() % n;
 }
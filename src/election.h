@@ -10,10 +10,14 @@
 #define SRC_ELECTION_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint>
 #include <fstream>
 #include "candidate.h"
 #include "ballot.h"
+#include "ballot_store.h"
+#include "object_pool.h"
 #include "election_logger.h"
 
 /**
@@ -30,6 +34,79 @@ public:
 	*/
 	virtual void Run() = 0;
 
+	/**
+		@brief Add one ballot to the election.
+
+		The ballot is assigned the next ballot ID. This lets a ballot file
+		be streamed into the election row by row after the election has
+		been constructed from the file's header.
+
+		@param row The fields of the ballot's row in the ballot file.
+	*/
+	void AddBallot(const std::vector<std::string_view>& row);
+
+	/**
+		@brief Add one ballot to the election from its decoded ranks.
+
+		@param ranks The rank given to each candidate, or `0` if the
+		candidate is not ranked.
+	*/
+	void AddBallot(const std::vector<uint16_t>& ranks);
+
+	/**
+		@brief Add one ballot to the election from its choices.
+
+		A ballot whose ranks repeated or skipped a rank is counted as its
+		choices say, and is reported in the audit file.
+
+		@param choices The candidate index of each choice on the ballot,
+		in order of preference.
+
+		@param status Whether the ranks the choices were made from were
+		valid, repeated a rank or skipped one.
+	*/
+	void AddBallotChoices(const std::vector<uint16_t>& choices, Ballot::RankStatus status=Ballot::kRanksValid);
+
+	/**
+		@brief Set whether identical ballots are counted once as a weighted group.
+
+		Must be called before any ballots are added. The audit file then
+		refers to each group of ballots with the ranges of its ballot IDs.
+	*/
+	void set_deduplicate(bool d) { ballots.set_deduplicate(d); }
+
+	/**
+		@brief Set whether votes are only counted, without tracking which ballots they come from.
+
+		Identical ballots are grouped without their ballot IDs, so memory is
+		proportional to the number of distinct rankings, and the audit file
+		reports vote totals instead of a line per ballot. Ballots that were
+		already added are grouped; must be called before the election is run.
+
+		Elections that only read each ballot's first choice (PO and OPL)
+		count each ballot as it is added and do not keep it, so memory is
+		proportional to the number of candidates whatever the number of
+		ballots.
+	*/
+	void set_count_only(bool c);
+
+	/**
+		@brief Set whether the audit file records where each ballot goes.
+
+		@param a Whether to write a line for each ballot. Defaults to `true`;
+		without them the audit file still records each step of the count.
+	*/
+	void set_audit_ballots(bool a) { audit_ballots = a; }
+
+	/**
+		@brief Set the number of threads that count and redistribute ballots.
+
+		@param n The number of threads, or `0` to use as many hardware
+		threads as the number of ballots warrants. The results and audit
+		file are the same for any number of threads.
+	*/
+	void set_num_threads(int n) { num_threads = n; }
+
 	/// Return the total number of candidates running in the election.
 	int get_total_candidates() { return total_candidates; }
 
@@ -42,12 +119,80 @@ public:
 	/// Return whether the i-th candidate wins in the election
 	bool is_winner(int i) { return winners[i]; }
 
+	/// Return the number of ballots that repeated or skipped a rank.
+	int get_total_rank_errors() { return total_rank_errors; }
+
+	/// Return the ballots casted in the election.
+	BallotStore& get_ballots() { return ballots; }
+
 protected:
 	/**
 		@brief Distribute all ballots to the corresponding candidates.
 	*/
 	virtual void DistributeBallots() = 0;
 
+	/**
+		@brief Add the ballot rows of parsed ballot data to the election.
+
+		@param data The parsed data from the ballot file.
+
+		@param first_row The index of the first ballot row in `data`.
+	*/
+	void AddBallots(const std::vector<std::vector<std::string>>& data, int first_row);
+
+	/**
+		@brief Check a ballot that has just been added to the election.
+
+		Derived classes override this to invalidate ballots that do not
+		meet the election's rules.
+
+		@param b The index of the ballot that was added.
+	*/
+	virtual void CheckBallot(int b) { (void) b; }
+
+	/**
+		@brief Count a ballot whose ranks repeated or skipped a rank, and
+		report it in the audit file.
+
+		@param status Whether the ballot's ranks repeated or skipped a rank.
+	*/
+	void CheckRanks(Ballot::RankStatus status);
+
+	/**
+		@brief Write the number of ballots that repeated or skipped a rank
+		to the audit file, if there were any and they were not reported
+		one at a time as they were added.
+	*/
+	void AuditRankErrors();
+
+	/**
+		@brief Return how the audit file refers to the b-th ballot, or group of ballots.
+
+		@param b The index of the ballot in `ballots`.
+	*/
+	std::string BallotLabel(int b);
+
+	/**
+		@brief Return the number of threads to process n ballots on.
+
+		@return The number of threads set with set_num_threads(), or if it is
+		`0`, as many hardware threads as n warrants. Never more than n.
+	*/
+	int ThreadsFor(int n);
+
+	/**
+		@brief Return whether ballots are counted as they are added instead of being kept.
+	*/
+	bool StreamsBallots() { return count_only && first_choice_only; }
+
+	/**
+		@brief Add the number of ballots whose first choice is each candidate
+		to that candidate's count.
+
+		@param votes The count of each candidate.
+	*/
+	void CountFirstChoices(std::vector<int>& votes);
+
 	/**
 		@brief Resolve an n-way tie.
 
@@ -76,11 +221,19 @@ protected:
 	/// A vector of pointers to Candidate instances.
 	std::vector<Candidate*> candidates;
 
+	/// The pool that owns the Candidate instances in `candidates`.
+	ObjectPool<Candidate> candidate_pool;
+
 	/// The total number of ballots casted in the election.
 	int total_ballots;
 
-	/// A vector of pointers to Ballot instances.
-	std::vector<Ballot*> ballots;
+	/**
+		@brief The ballots casted in the election.
+
+		A ballot's index is its ID number, unless identical ballots are
+		stored as groups.
+	*/
+	BallotStore ballots;
 
 	/**
 		@brief A boolean vector indicating the winners of the election.
@@ -91,7 +244,30 @@ protected:
 	std::vector<bool> winners;
 
 	/// The logger for the election.
-	ElectionLogger* logger;
+	ElectionLogger* logger{nullptr};
+
+	/// Whether votes are only counted, without tracking which ballots they come from.
+	bool count_only{false};
+
+	/// Whether the audit file records where each ballot goes.
+	bool audit_ballots{true};
+
+	/// The number of threads that count and redistribute ballots, or `0` to choose automatically.
+	int num_threads{0};
+
+	/// The number of ballots that repeated or skipped a rank.
+	int total_rank_errors{0};
+
+	/// Whether the election only reads each ballot's first choice, so that
+	/// count-only mode can count ballots as they are added.
+	bool first_choice_only{false};
+
+	/// The votes of each candidate counted as ballots are added, when ballots are not kept.
+	std::vector<int> first_choice_votes;
+
+private:
+	/// The choices of the ballot being added, kept to reuse its memory.
+	std::vector<uint16_t> ballot_choices;
 };
 
 #endif
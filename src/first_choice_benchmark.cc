@@ -0,0 +1,49 @@
+/**
+	@file first_choice_benchmark.cc
+
+	Benchmark of counting the first choices of single-choice ballots, as
+	in OPL and PO elections, on increasing numbers of threads
+
+	Usage: `first_choice_benchmark [ballots] [candidates]`.
+	Defaults to 50000000 synthetic ballots over 10 candidates.
+*/
+
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include "ballot_store.h"
+
+/// Main function of the benchmark.
+int main(int argc, char* argv[]) {
+	int ballots = (argc > 1) ? std::atoi(argv[1]) : 50000000;
+	int candidates = (argc > 2) ? std::atoi(argv[2]) : 10;
+
+	BallotStore store(candidates);
+	store.Reserve(ballots, ballots);
+	std::mt19937 rng(12345);
+	std::vector<uint16_t> choice(1);
+	for (int b = 0; b < ballots; b++) {
+		choice[0] = (uint16_t) (rng() % candidates);
+		store.Add(choice);
+	}
+	std::cout << ballots << " ballots, " << candidates << " candidates\n";
+
+	int max_threads = (int) std::max(1u, std::thread::hardware_concurrency());
+	for (int threads = 1; ; threads = std::min(2 * threads, max_threads)) {
+		std::vector<int> counts(candidates, 0);
+		auto start = std::chrono::steady_clock::now();
+		store.CountChoices(counts, threads);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << "  " << threads << (threads == 1 ? " thread: " : " threads: ") << elapsed.count() << " s, "
+			<< ballots / elapsed.count() / 1e6 << " M ballots/s (candidate 0: " << counts[0] << " votes)\n";
+		if (threads == max_threads) {
+			break;
+		}
+	}
+	return 0;
+}
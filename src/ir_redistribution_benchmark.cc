@@ -0,0 +1,104 @@
+/**
+	@file ir_redistribution_benchmark.cc
+
+	Benchmark of IR elections that redistribute ballots by lists of
+	ballot IDs against ones that keep each candidate's ballots in a pile,
+	and ones that count the ballots in a trie of their rankings
+
+	Usage: `ir_redistribution_benchmark [ballots] [candidates] [rankings]`.
+	Defaults to 10000000 synthetic ballots over 10 candidates. Each
+	engine is run twice: once with every ballot ranked at random, so
+	nearly every ballot is distinct, and once with every ballot copying
+	one of a few distinct rankings (100 by default), as when most voters
+	follow a party's how-to-vote card. Few distinct rankings suit the trie.
+*/
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include "irelection.h"
+
+namespace {
+
+/// Return the header lines of an IR election with the given number of candidates.
+std::vector<std::vector<std::string>> Header(int candidates, int ballots) {
+	std::vector<std::vector<std::string>> data{{"IR"}, {std::to_string(candidates)}, {}, {std::to_string(ballots)}};
+	for (int c = 0; c < candidates; c++) {
+		data[2].push_back("C" + std::to_string(c));
+		data[2].push_back("P");
+	}
+	return data;
+}
+
+/// Return a random ranking of between half and all of the candidates.
+std::vector<uint16_t> RandomRanking(std::mt19937& rng, std::vector<uint16_t>& order) {
+	std::shuffle(order.begin(), order.end(), rng);
+	int candidates = (int) order.size();
+	int n = (candidates + 1) / 2 + (int) (rng() % (candidates / 2 + 1));
+	return std::vector<uint16_t>(order.begin(), order.begin() + n);
+}
+
+/// Add random ballots, each copying one of the given number of random rankings, or all distinct if it is 0.
+void AddBallots(IRElection& e, int candidates, int ballots, int rankings) {
+	std::mt19937 rng(12345);
+	std::vector<uint16_t> order(candidates);
+	std::iota(order.begin(), order.end(), 0);
+	std::vector<std::vector<uint16_t>> pool;
+	for (int r = 0; r < rankings; r++) {
+		pool.push_back(RandomRanking(rng, order));
+	}
+	for (int b = 0; b < ballots; b++) {
+		e.AddBallotChoices(pool.empty() ? RandomRanking(rng, order) : pool[rng() % pool.size()]);
+	}
+}
+
+}  // namespace
+
+/// Main function of the benchmark.
+int main(int argc, char* argv[]) {
+	int ballots = (argc > 1) ? std::atoi(argv[1]) : 10000000;
+	int candidates = (argc > 2) ? std::atoi(argv[2]) : 10;
+	int few_rankings = (argc > 3) ? std::atoi(argv[3]) : 100;
+	std::cout << ballots << " ballots, " << candidates << " candidates\n";
+
+	const char* names[] = {"Ballot ID lists", "Ballot piles", "Ranking trie"};
+	for (int rankings : {0, few_rankings}) {
+		if (rankings == 0) {
+			std::cout << "Every ballot ranked at random:\n";
+		} else {
+			std::cout << "Every ballot copying one of " << rankings << " rankings:\n";
+		}
+		for (IRElection::Engine engine : {IRElection::kBallotList, IRElection::kPiles, IRElection::kTrie}) {
+			IRElection e(Header(candidates, ballots), "/tmp/");
+			e.set_audit_ballots(false);
+			e.set_num_threads(1);
+			e.set_batch_elimination(false);
+			e.set_engine(engine);
+			AddBallots(e, candidates, ballots, rankings);
+
+			// The results printed by Run() are not part of the benchmark
+			std::streambuf* out = std::cout.rdbuf(nullptr);
+			auto start = std::chrono::steady_clock::now();
+			e.Run();
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			std::cout.rdbuf(out);
+			std::size_t moved = 0;
+			for (std::size_t bytes : e.get_bytes_moved()) {
+				moved += bytes;
+			}
+			int winner = 0;
+			while (winner < candidates && !e.is_winner(winner)) {
+				winner++;
+			}
+			std::cout << "  " << names[engine] << ": " << elapsed.count() << " s, "
+				<< (double) moved / (1 << 20) << " MB moved (winner C" << winner << ")\n";
+		}
+	}
+	return 0;
+}
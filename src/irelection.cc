@@ -7,7 +7,10 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <algorithm>
 #include "irelection.h"
+#include "parallel_for.h"
+#include "tally_heap.h"
 
 IRElection::IRElection(std::vector<std::vector<std::string>> data, std::string output_dir) {
     // Number of candidates and ballots
@@ -25,31 +28,32 @@ IRElection::IRElection(std::vector<std::vector<std::string>> data, std::string o
 
     // Convert candidate strings to Candidate instances
     for (int i=0; i<total_candidates; i++) {
-        candidates.push_back(new Candidate(data[2][2*i], data[2][2*i+1]));
+        candidates.push_back(candidate_pool.New(data[2][2*i], data[2][2*i+1]));
     }
 
     // Set up the election logger
     SetUpLogger(output_dir);
 
-    // Convert ballot strings to Ballot instances
-    for (int i=0; i<total_ballots; i++) {
-        std::vector<std::string> bstr = data[i+4];
-        Ballot* b = new Ballot(bstr, i);
-        if ((float) b->get_total_choices() / total_candidates < 0.5) {
-            b->SetInvalid();
-            total_invalid_ballots++;
-            logger->WriteToAuditFile("Ballot " + std::to_string(i) + " does not have at least half of the candidates ranked and is now invalidated.\n");
-        }
-        ballots.push_back(b);
-    }
+    // Convert ballot strings to ballots in the ballot store
+    ballots = BallotStore(total_candidates);
+    AddBallots(data, 4);
 }
 
 IRElection::~IRElection() {
-    for (auto c : candidates) delete c;
-    for (auto b : ballots) delete b;
     delete logger;
 }
 
+void IRElection::CheckBallot(int b) {
+    if ((float) ballots.get_total_choices(b) / total_candidates < 0.5) {
+        ballots.SetInvalid(b);
+        total_invalid_ballots++;
+        // Groups of ballots are reported once all of their IDs are known
+        if (!ballots.get_deduplicate() && audit_ballots) {
+            logger->WriteToAuditFile("Ballot " + std::to_string(b) + " does not have at least half of the candidates ranked and is now invalidated.\n");
+        }
+    }
+}
+
 void IRElection::Run(){
 
     // can't have zero votes!
@@ -65,6 +69,13 @@ void IRElection::Run(){
 
     DistributeBallots();
 
+    // order the candidates by their tallies
+    std::vector<int> first_tallies;
+    for (int i = 0; i < total_candidates; i++) {
+        first_tallies.push_back(candidates[i]->get_total_votes());
+    }
+    tallies = TallyHeap(first_tallies);
+
     // keep track of how many candidates are still in the running --
     // for edge case where there is no clear majority
     int candidates_in_running = total_candidates;
@@ -86,109 +97,293 @@ void IRElection::Run(){
         }
         // 2 or more candidates, so eliminate one with lowest number of votes and redistribute them
         else {
-            for (int i=0; i < total_candidates; i++) {
-                // check for a clear winner
-                if (candidates[i]->get_total_votes() > majority) {
-                    winners[i] = true;
-                    win_flag = true;
-                    logger->WriteToAuditFile("\nWinner declared with clear majority:\n");
-                    logger->WriteToAuditFile("Candidate " + std::to_string(i) + " with " + std::to_string(candidates[i]->get_total_votes()) + " votes.\n");
-                    AnnounceResults();
-                    break;
-                }
+            // check for a clear winner; only the candidate with the most votes can have a majority
+            int leader = tallies.Max();
+            if (candidates[leader]->get_total_votes() > majority) {
+                winners[leader] = true;
+                win_flag = true;
+                logger->WriteToAuditFile("\nWinner declared with clear majority:\n");
+                logger->WriteToAuditFile("Candidate " + std::to_string(leader) + " with " + std::to_string(candidates[leader]->get_total_votes()) + " votes.\n");
+                AnnounceResults();
+            }
+            int eliminated = 0;
+            if (batch_elimination && !win_flag) {
+                eliminated = EliminateDefeatedCandidates();
             }
-            EliminateCandidate();
-            candidates_in_running--;
+            if (eliminated == 0) {
+                EliminateCandidate();
+                eliminated = 1;
+            }
+            candidates_in_running -= eliminated;
         }
     }
 }
 
 void IRElection::DistributeBallots(){
+    AuditRankErrors();
+    if (count_only || !audit_ballots) {
+        if (total_invalid_ballots > 0) {
+            logger->WriteToAuditFile(std::to_string(total_invalid_ballots) + " ballots do not have at least half of the candidates ranked and are invalidated.\n");
+        }
+    } else if (ballots.get_deduplicate()) {
+        for (int id = 0; id < ballots.size(); id++) {
+            if (!ballots.get_valid(id)) {
+                logger->WriteToAuditFile(BallotLabel(id) + " does not have at least half of the candidates ranked and is now invalidated.\n");
+            }
+        }
+    }
+
+    if (count_only) {
+        logger->WriteToAuditFile("\nInitial Vote Totals:\n");
+        CountGroups();
+        return;
+    }
+
+    std::vector<uint16_t> choices;
+    if (engine == kTrie) {
+        trie = RankingTrie(total_candidates);
+        for (int id = 0; id < ballots.size(); id++) {
+            if (ballots.get_valid(id)) {
+                ballots.GetChoices(id, choices);
+                trie.Add(choices.data(), (int) choices.size(), ballots.get_weight(id));
+            }
+        }
+        logger->WriteToAuditFile("\nInitial Vote Totals:\n");
+        CountTrie();
+        return;
+    }
+
     logger->WriteToAuditFile("\nInitial Ballot Distribution:\n");
-    for (const auto& b : ballots) {
-        if (b->get_valid()) {
-          int id = b->get_id();
-          int choice = b->GetChoice();
-          candidates[choice]->AddBallotId(id);
-          logger->WriteToAuditFile("Ballot " + std::to_string(id) + " to Candidate " + std::to_string(choice) + "\n");
+    std::string audit;
+    if (engine == kPiles) {
+        piles = BallotPiles(total_candidates);
+    }
+    for (int id = 0; id < ballots.size(); id++) {
+        if (ballots.get_valid(id)) {
+          int choice = ballots.GetChoice(id);
+          if (engine == kPiles) {
+              // the pile keeps the choices after the candidate the ballot goes to
+              ballots.GetChoices(id, choices);
+              piles.Add(choice, id, choices.data() + 1, (int) choices.size() - 1);
+              candidates[choice]->AddVotes(ballots.get_weight(id));
+          } else {
+              candidates[choice]->AddBallotId(id, ballots.get_weight(id));
+          }
+          if (audit_ballots) {
+              audit += BallotLabel(id) + " to Candidate " + std::to_string(choice) + "\n";
+          }
         }
     }
+    logger->WriteToAuditFile(audit);
 }
 
 void IRElection::RedistributeBallots(int c) {
+    if (count_only) {
+        logger->WriteToAuditFile("\nVote Totals:\n");
+        CountGroups();
+        return;
+    }
+    if (engine == kTrie) {
+        // splicing moves the ballots of every eliminated candidate at once
+        trie.Eliminate(candidate_eliminated);
+        logger->WriteToAuditFile("\nVote Totals:\n");
+        CountTrie();
+        return;
+    }
+
     logger->WriteToAuditFile("\nBallot Redistribution:\n");
+    if (engine == kPiles) {
+        RedistributePile(c);
+        return;
+    }
 
     // store some temp variables about ballots to be removed from one candidate and redistributed
     std::vector<int> ballots_to_redistribute = candidates[c]->RemoveVotes();
+    int total = (int) ballots_to_redistribute.size();
 
-    for (const int& j : ballots_to_redistribute) {
-        Ballot* b = ballots[j];
-        b->IncrementRank();
-        int id = b->get_id();
-        int choice = b->GetChoice();
-        // if there is a valid incremented choice filled out on ballot
-        if (choice != -1) {
-            candidates[choice]->AddBallotId(id);
-            logger->WriteToAuditFile("Ballot " + std::to_string(id) + " to Candidate " + std::to_string(choice) + "\n");
-        } else {
-            logger->WriteToAuditFile("Ballot " + std::to_string(id) + " has no more valid ranks and is now unassigned.\n");
+    // split the ballots into one contiguous part per thread
+    int threads = ThreadsFor(total);
+
+    // each thread collects the ballots, votes and audit lines for each candidate in its part
+    std::vector<std::vector<std::vector<int>>> moved_ids(threads, std::vector<std::vector<int>>(total_candidates));
+    std::vector<std::vector<int>> moved_votes(threads, std::vector<int>(total_candidates, 0));
+    std::vector<std::string> audit(threads);
+    ParallelFor(threads, [&](int t) {
+        int first = (int) ((long long) total * t / threads);
+        int last = (int) ((long long) total * (t + 1) / threads);
+        for (int j = first; j < last; j++) {
+            int id = ballots_to_redistribute[j];
+            // move past the loser and any other eliminated candidates
+            int choice = ballots.AdvanceChoice(id, candidate_eliminated);
+            // if there is a valid incremented choice filled out on ballot
+            if (choice != -1) {
+                moved_ids[t][choice].push_back(id);
+                moved_votes[t][choice] += ballots.get_weight(id);
+                if (audit_ballots) {
+                    audit[t] += BallotLabel(id) + " to Candidate " + std::to_string(choice) + "\n";
+                }
+            } else if (audit_ballots) {
+                audit[t] += BallotLabel(id) + " has no more valid ranks and is now unassigned.\n";
+            }
+        }
+    });
+
+    // merge the parts in order, so the result is the same as one pass over the ballots
+    std::size_t moved = 0;
+    for (int t = 0; t < threads; t++) {
+        logger->WriteToAuditFile(audit[t]);
+        for (int k = 0; k < total_candidates; k++) {
+            if (moved_ids[t][k].empty()) {
+                continue;
+            }
+            candidates[k]->AddBallotIds(moved_ids[t][k], moved_votes[t][k]);
+            tallies.Update(k, candidates[k]->get_total_votes());
+            moved += moved_ids[t][k].size() * sizeof(int);
         }
     }
+    bytes_moved.push_back(moved);
 }
 
-void IRElection::EliminateCandidate() {
-    int temp_cand;
-    int tie_winner;
-    int temp_votes = total_ballots;
-    bool tie_flag = false;
-    int tied_cands[5] = {-1,-1,-1,-1,-1};
-    int j = 0;
+void IRElection::RedistributePile(int c) {
+    std::vector<uint16_t> pile = piles.Take(c);
+    candidates[c]->set_total_votes(0);
 
-    for (int i=0; i < total_candidates; i++) {
-        // make sure the candidate is still valid
-        if (candidate_eliminated[i] == false) {
-            if (candidates[i]->get_total_votes() < temp_votes) {
-                // keeping track of lowest number of votes in each pass through 'for' loop
-                temp_votes = candidates[i]->get_total_votes();
-                // keeping track of candidate with lowest number of votes in each pass through 'for' loop
-                temp_cand = i;
-                // if there is a new low count, lower than an earlier coin toss result
-                tie_flag = false;
-            }
-            // if vote total is the same, then the tie is resolved
-            else if (candidates[i]->get_total_votes() == temp_votes) {
-                tie_flag = true;
-                // candidate number put in tied_cands array
-                tied_cands[j] = i;
-                j++;   // ready for next possible tie
+    // scan the loser's pile in order, appending each ballot to the pile of its next continuing choice
+    std::vector<bool> changed(total_candidates, false);
+    std::string audit;
+    std::size_t moved = 0;
+    std::size_t pos = 0;
+    int id;
+    const uint16_t* rest;
+    int n;
+    while (BallotPiles::Read(pile, pos, id, rest, n)) {
+        int k = 0;
+        while (k < n && candidate_eliminated[rest[k]]) {
+            k++;
+        }
+        if (k < n) {
+            int choice = rest[k];
+            piles.Add(choice, id, rest + k + 1, n - k - 1);
+            candidates[choice]->AddVotes(ballots.get_weight(id));
+            changed[choice] = true;
+            moved += BallotPiles::RecordBytes(n - k - 1);
+            if (audit_ballots) {
+                audit += BallotLabel(id) + " to Candidate " + std::to_string(choice) + "\n";
             }
+        } else if (audit_ballots) {
+            audit += BallotLabel(id) + " has no more valid ranks and is now unassigned.\n";
         }
     }
-    if (tie_flag == true) {
-        // get index of winning candidate of coin toss
-        tie_winner = ResolveTie(j);
-        logger->WriteToAuditFile("\nLowest count tie resolved with coin toss.\n");
+    logger->WriteToAuditFile(audit);
 
-        for (int i = 0; i < 5; i++)
-        {
-            if (tied_cands[i] > -1)
-            {
-                if (i == tie_winner)
-                {
-                    logger->WriteToAuditFile("Candidate " + std::to_string(tied_cands[i]) + " wins coin toss, not eliminated.\n");
-                }
-                else
-                {
-                    logger->WriteToAuditFile("Candidate " + std::to_string(tied_cands[i]) + " loses coin toss.\n");
-                }
+    for (int k = 0; k < total_candidates; k++) {
+        if (changed[k]) {
+            tallies.Update(k, candidates[k]->get_total_votes());
+        }
+    }
+    bytes_moved.push_back(moved);
+}
+
+void IRElection::CountGroups() {
+    std::vector<int> totals(total_candidates, 0);
+    for (int g = 0; g < ballots.size(); g++) {
+        if (!ballots.get_valid(g)) {
+            continue;
+        }
+        // skip eliminated candidates; a group's rank only ever moves forward
+        int choice = ballots.SkipEliminated(g, candidate_eliminated);
+        if (choice != -1) {
+            totals[choice] += ballots.get_weight(g);
+        }
+    }
+    SetVoteTotals(totals);
+}
+
+void IRElection::CountTrie() {
+    std::vector<int> totals(total_candidates);
+    for (int i = 0; i < total_candidates; i++) {
+        totals[i] = trie.get_count(i);
+    }
+    SetVoteTotals(totals);
+}
+
+void IRElection::SetVoteTotals(const std::vector<int>& totals) {
+    for (int i = 0; i < total_candidates; i++) {
+        candidates[i]->set_total_votes(totals[i]);
+        tallies.Update(i, totals[i]);
+        if (!candidate_eliminated[i]) {
+            logger->WriteToAuditFile("Candidate " + std::to_string(i) + ": " + std::to_string(totals[i]) + " votes\n");
+        }
+    }
+}
+
+void IRElection::EliminateCandidate() {
+    // every candidate still running with the fewest votes
+    std::vector<int> tied_cands = tallies.MinGroup();
+    int loser = tied_cands[0];
+
+    if (tied_cands.size() > 1) {
+        // the loser of the coin toss is eliminated
+        loser = tied_cands[ResolveTie((int) tied_cands.size())];
+        logger->WriteToAuditFile("\nLowest count tie resolved with coin toss.\n");
+        for (int c : tied_cands) {
+            if (c == loser) {
+                logger->WriteToAuditFile("Candidate " + std::to_string(c) + " loses coin toss.\n");
+            } else {
+                logger->WriteToAuditFile("Candidate " + std::to_string(c) + " wins coin toss, not eliminated.\n");
             }
         }
     }
-    logger->WriteToAuditFile("\nCandidate " + std::to_string(temp_cand) + " eliminated.\n");
+    logger->WriteToAuditFile("\nCandidate " + std::to_string(loser) + " eliminated.\n");
     // put candidate in 'eliminated' boolean array
-    candidate_eliminated[temp_cand] = true;
+    candidate_eliminated[loser] = true;
+    tallies.Remove(loser);
     // redistribute loser's ballots
-    RedistributeBallots(temp_cand);
+    RedistributeBallots(loser);
+}
+
+int IRElection::EliminateDefeatedCandidates() {
+    // find the largest k for which the lowest k candidates have fewer votes combined than the next one,
+    // walking up from the fewest votes; once the lowest candidates hold half of the votes, no candidate
+    // after them can have more votes than they do combined
+    std::vector<int> running;
+    int batch = 0;
+    long long combined = 0;
+    long long batch_votes = 0;
+    long long total = tallies.get_total();
+    tallies.Walk([&](int c) {
+        if (!running.empty() && combined < tallies.get_tally(c)) {
+            batch = (int) running.size();
+            batch_votes = combined;
+        }
+        running.push_back(c);
+        combined += tallies.get_tally(c);
+        return 2 * combined < total;
+    });
+    if (batch < 2) {
+        return 0;
+    }
+
+    std::string names;
+    for (int j = 0; j < batch; j++) {
+        names += (j == 0 ? "" : ", ") + std::to_string(running[j]);
+        candidate_eliminated[running[j]] = true;
+        tallies.Remove(running[j]);
+    }
+    logger->WriteToAuditFile("\nCandidates " + names + " eliminated together: their combined " + std::to_string(batch_votes)
+        + " votes are fewer than the " + std::to_string(candidates[running[batch]]->get_total_votes())
+        + " votes of Candidate " + std::to_string(running[batch]) + ".\n");
+
+    if (count_only || engine == kTrie) {
+        // one count moves the votes of every candidate in the batch
+        RedistributeBallots(running[0]);
+    } else {
+        for (int j = 0; j < batch; j++) {
+            logger->WriteToAuditFile("\nCandidate " + std::to_string(running[j]) + " eliminated.\n");
+            RedistributeBallots(running[j]);
+        }
+    }
+    return batch;
 }
 
 void IRElection::AnnounceResults(){
@@ -11,8 +11,12 @@
 
 #include <string>
 #include <vector>
+#include <cstddef>
 
 #include "election.h"
+#include "tally_heap.h"
+#include "ballot_piles.h"
+#include "ranking_trie.h"
 
 /**
 	@brief Class that represents an election using Instant Runoff voting.
@@ -37,6 +41,47 @@ public:
 
 		void Run() override;
 
+		/// The ways of keeping track of which candidate each ballot is assigned to.
+		enum Engine {
+				/// Each candidate keeps a list of the IDs of its ballots.
+				kBallotList,
+				/// Each candidate keeps its ballots in one contiguous pile (see
+				/// BallotPiles). A pile copies each ballot's remaining choices
+				/// along with its ID, so it moves several times the bytes of
+				/// kBallotList, but it reads them in order instead of looking
+				/// each ballot up in the store. It is only faster when ballots
+				/// rank many candidates, about 20 or more, and slower with few.
+				kPiles,
+				/// Ballots are counted in a prefix trie of their rankings (see
+				/// RankingTrie). The audit file records the vote totals of each
+				/// round instead of where each ballot goes. A round costs time in
+				/// the number of distinct rankings, but building the trie costs
+				/// time in every choice of every ballot, so it only pays off when
+				/// ballots share a few rankings over many candidates; on ballots
+				/// that are nearly all distinct it is an order of magnitude slower
+				/// than kBallotList.
+				kTrie
+		};
+
+		/**
+				@brief Set how the election keeps track of which candidate each ballot is assigned to.
+				@param e The engine. Defaults to kBallotList. The results are the
+				same for every engine.
+		*/
+		void set_engine(Engine e) { engine = e; }
+
+		/**
+				@brief Return the number of bytes of Ballot IDs moved to other
+				candidates in each round of redistribution.
+		*/
+		const std::vector<std::size_t>& get_bytes_moved() { return bytes_moved; }
+
+		/**
+				@brief Set whether candidates who cannot win are eliminated together in one round.
+				@param b Whether to eliminate defeated candidates in batches. Defaults to `true`.
+		*/
+		void set_batch_elimination(bool b) { batch_elimination = b; }
+
 private:
 		/**
 				@brief initial distribution of ballots
@@ -50,12 +95,54 @@ private:
 		*/
 		void RedistributeBallots(int c);
 
+		/**
+				@brief Redistribute a losing candidate's pile of ballots, when using the kPiles engine.
+				@param c The index of the candidate whose ballots are to
+				be redistributed.
+		*/
+		void RedistributePile(int c);
+
+		/**
+				@brief Count each remaining candidate's votes from the groups of identical ballots.
+				Used instead of distributing ballots when only counting votes. Each
+				group counts for its first choice that is not eliminated, so a round
+				costs time proportional to the number of distinct rankings.
+		*/
+		void CountGroups();
+
+		/**
+				@brief Set each remaining candidate's votes from the trie of rankings,
+				when using the kTrie engine.
+		*/
+		void CountTrie();
+
+		/**
+				@brief Set each candidate's votes and write them to the audit file.
+				@param totals The number of votes of each candidate.
+		*/
+		void SetVoteTotals(const std::vector<int>& totals);
+
 		/**
 				@brief find candidate with lowest number of votes -- the 'loser'
 				and call RedistributeVotes with the loser's votes
 		*/
 		void EliminateCandidate();
 
+		/**
+				@brief Eliminate the lowest k candidates together when their combined
+				votes are fewer than the votes of the next lowest candidate, so none
+				of them can overtake that candidate in later rounds.
+				@return The number of candidates eliminated, or 0 if fewer than two
+				candidates are defeated this way.
+		*/
+		int EliminateDefeatedCandidates();
+
+		/**
+				@brief Invalidate a ballot that ranks fewer than half of the candidates.
+				@param b The index of the ballot that was added.
+		*/
+		void CheckBallot(int b) override;
+
 		/**
 				@brief announce winner to terminal, output media and audit files
 		*/
@@ -76,6 +163,24 @@ private:
 
 		/// The number of invalid ballots.
 		int total_invalid_ballots{0};
+
+		/// The number of bytes of Ballot IDs moved in each round of redistribution.
+		std::vector<std::size_t> bytes_moved;
+
+		/// Whether candidates who cannot win are eliminated together in one round.
+		bool batch_elimination{true};
+
+		/// The tallies of the candidates still running, ordered by their votes.
+		TallyHeap tallies;
+
+		/// How the election keeps track of which candidate each ballot is assigned to.
+		Engine engine{kBallotList};
+
+		/// The pile of ballots of each candidate, when using the kPiles engine.
+		BallotPiles piles;
+
+		/// The trie of the ballots' rankings, when using the kTrie engine.
+		RankingTrie trie;
 };
 
 #endif
@@ -11,6 +11,7 @@
 #include "gtest/gtest.h"
 #include "irelection.h"
 #include "votingsystem.h"
+#include "test_ballot_rows.h"
 
 /// Test fixture for testing the IRElection class.
 class IRElectionTest : public ::testing::Test {
@@ -58,3 +59,151 @@ TEST_F(IRElectionTest, IRElectionWinner) {
 	EXPECT_TRUE(e->is_winner(1));
 	EXPECT_TRUE(e->is_winner(3));
 }**/
+
+namespace {
+
+/// Return ballot data for an election that candidate A wins after D and
+/// then C are eliminated, without any ties.
+std::vector<std::vector<std::string>> RunoffData() {
+	std::vector<std::vector<std::string>> data{{"IR"}, {"4"}, {"A", "P", "B", "P", "C", "P", "D", "P"}, {"14"}};
+	AddBallotRows(data, {{{"1", "2", "", ""}, 5}, {{"", "1", "2", ""}, 4}, {{"2", "", "1", ""}, 3}, {{"", "2", "", "1"}, 2}});
+	return data;
+}
+
+}  // namespace
+
+/// Test that each round of redistribution records the bytes of Ballot IDs it moved.
+TEST(IRElectionBytesMovedTest, IRElectionBytesMoved) {
+	for (bool batch : {true, false}) {
+		IRElection e(RunoffData(), "../testing/");
+		e.set_batch_elimination(batch);
+		e.Run();
+		// D's 2 ballots move to B, then C's 3 ballots move to A; the round
+		// after A wins still eliminates B, whose ballots have no other choice
+		std::vector<std::size_t> expected{2 * sizeof(int), 3 * sizeof(int), 0};
+		EXPECT_EQ(e.get_bytes_moved(), expected);
+	}
+}
+
+/// Test that redistributing on several threads gives the same result as on one.
+TEST(IRElectionThreadsTest, IRElectionRedistributeThreads) {
+	std::vector<std::vector<std::string>> data = RunoffData();
+
+	std::vector<std::vector<int>> votes;
+	std::vector<std::vector<std::size_t>> moved;
+	for (int threads = 1; threads <= 4; threads++) {
+		IRElection e(data, "../testing/");
+		e.set_num_threads(threads);
+		e.Run();
+		EXPECT_TRUE(e.is_winner(0));
+		votes.emplace_back();
+		for (int i = 0; i < e.get_total_candidates(); i++) {
+			votes.back().push_back(e.get_candidate(i).get_total_votes());
+		}
+		moved.push_back(e.get_bytes_moved());
+	}
+	for (int t = 1; t < 4; t++) {
+		EXPECT_EQ(votes[t], votes[0]);
+		EXPECT_EQ(moved[t], moved[0]);
+	}
+}
+
+/// Test that counting votes from groups of identical ballots finds the same winner.
+TEST(IRElectionCountOnlyTest, IRElectionCountOnly) {
+	IRElection e(RunoffData(), "../testing/");
+	e.set_count_only(true);
+	e.Run();
+	EXPECT_TRUE(e.is_winner(0));
+	EXPECT_EQ(e.get_candidate(0).get_total_votes(), 8);
+	EXPECT_EQ(e.get_candidate(2).get_total_votes(), 0);
+	EXPECT_EQ(e.get_candidate(3).get_total_votes(), 0);
+}
+
+/// Test that eliminating defeated candidates together finds the same winner as one at a time.
+TEST(IRElectionBatchTest, IRElectionBatchElimination) {
+	std::vector<std::vector<std::string>> data{{"IR"}, {"5"}, {"A", "P", "B", "P", "C", "P", "D", "P", "E", "P"}, {"14"}};
+	AddBallotRows(data, {{{"1", "2", "3", "", ""}, 6}, {{"2", "1", "3", "", ""}, 5},
+		{{"2", "", "1", "3", ""}, 1}, {{"2", "", "", "1", "3"}, 1}, {{"2", "", "3", "", "1"}, 1}});
+
+	for (bool batch : {true, false}) {
+		IRElection e(data, "../testing/");
+		e.set_batch_elimination(batch);
+		e.Run();
+		EXPECT_TRUE(e.is_winner(0));
+		EXPECT_FALSE(e.is_winner(1));
+	}
+}
+
+/// Test that a tie among more than five candidates eliminates one of them.
+TEST(IRElectionTieTest, IRElectionWideTie) {
+	int n = 7;
+	std::vector<std::vector<std::string>> data{{"IR"}, {std::to_string(n)}, {}, {std::to_string(n)}};
+	for (int i = 0; i < n; i++) {
+		data[2].push_back("C" + std::to_string(i));
+		data[2].push_back("P");
+	}
+	for (int i = 0; i < n; i++) {
+		std::vector<std::string> row(n, "");
+		for (int r = 0; r < 4; r++) {
+			row[(i + r) % n] = std::to_string(r + 1);
+		}
+		data.push_back(row);
+	}
+
+	IRElection e(data, "../testing/");
+	e.set_batch_elimination(false);
+	e.Run();
+	int total_winners = 0;
+	for (int i = 0; i < n; i++) {
+		total_winners += e.is_winner(i);
+	}
+	EXPECT_EQ(total_winners, 1);
+}
+
+/// Test that keeping ballots in piles gives the same result as keeping lists of their IDs.
+TEST(IRElectionPilesTest, IRElectionPiles) {
+	std::vector<std::vector<std::string>> data = RunoffData();
+	std::vector<std::vector<int>> votes;
+	std::vector<std::vector<std::size_t>> moved;
+	for (IRElection::Engine engine : {IRElection::kBallotList, IRElection::kPiles}) {
+		IRElection e(data, "../testing/");
+		e.set_engine(engine);
+		e.set_batch_elimination(false);
+		e.Run();
+		EXPECT_TRUE(e.is_winner(0));
+		votes.emplace_back();
+		for (int i = 0; i < e.get_total_candidates(); i++) {
+			votes.back().push_back(e.get_candidate(i).get_total_votes());
+		}
+		moved.push_back(e.get_bytes_moved());
+	}
+	EXPECT_EQ(votes[1], votes[0]);
+
+	// A ballot list moves one ID per ballot, while a pile moves each ballot's
+	// record: its ID, its number of remaining choices and those choices. D's
+	// 2 ballots and then C's 3 ballots have no choices left once they move.
+	std::vector<std::size_t> list_bytes{2 * sizeof(int), 3 * sizeof(int), 0};
+	std::vector<std::size_t> pile_bytes{2 * BallotPiles::RecordBytes(0), 3 * BallotPiles::RecordBytes(0), 0};
+	EXPECT_EQ(moved[0], list_bytes);
+	EXPECT_EQ(moved[1], pile_bytes);
+	EXPECT_EQ(BallotPiles::RecordBytes(0), 3 * sizeof(uint16_t));
+}
+
+/// Test that counting ballots in a trie of their rankings gives the same result as distributing them.
+TEST(IRElectionTrieTest, IRElectionTrie) {
+	for (bool batch : {true, false}) {
+		std::vector<std::vector<int>> votes;
+		for (IRElection::Engine engine : {IRElection::kBallotList, IRElection::kTrie}) {
+			IRElection e(RunoffData(), "../testing/");
+			e.set_engine(engine);
+			e.set_batch_elimination(batch);
+			e.Run();
+			EXPECT_TRUE(e.is_winner(0));
+			votes.emplace_back();
+			for (int i = 0; i < e.get_total_candidates(); i++) {
+				votes.back().push_back(e.get_candidate(i).get_total_votes());
+			}
+		}
+		EXPECT_EQ(votes[1], votes[0]);
+	}
+}
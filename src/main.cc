@@ -9,10 +9,32 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cstdlib>
 #include "votingsystem.h"
 
-/// Main function of the voting system.
-int main() {
+/**
+    Main function of the voting system.
+
+    Run as `voting-system --compile <output.vbc> <ballot files...>` to compile
+    ballot files into a binary ballot file instead of running an election.
+    Run as `voting-system --deduplicate` to count identical ballots once as
+    a weighted group, or `voting-system --count-only` to also leave out the
+    ballot IDs and report only vote totals in the audit file. PO and OPL
+    elections then count each ballot as it is read without keeping it.
+    Add `--threads <n>` to read and count the ballots on n threads instead
+    of every hardware thread.
+*/
+int main(int argc, char* argv[]) {
+    // Compile ballot files if asked to
+    if (argc > 1 && std::string(argv[1]) == "--compile") {
+        if (argc < 4) {
+            std::cout << "Usage: " << argv[0] << " --compile <output.vbc> <ballot files...>\n";
+            return 1;
+        }
+        std::vector<std::string> inputs(argv + 3, argv + argc);
+        return VotingSystem::CompileBallotFile(inputs, argv[2]) ? 0 : 1;
+    }
+
     std::string welcome_message;
     std::string user_input;
     std::vector<std::string> filenames;
@@ -51,6 +73,15 @@ int main() {
     }
 
     vs->set_filenames(filenames);
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--deduplicate") {
+            vs->set_deduplicate(true);
+        } else if (std::string(argv[i]) == "--count-only") {
+            vs->set_count_only(true);
+        } else if (std::string(argv[i]) == "--threads" && i + 1 < argc) {
+            vs->set_num_threads(std::atoi(argv[++i]));
+        }
+    }
     
     // Start counting votes and generating reports
     vs->StartAnElection();
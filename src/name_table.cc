@@ -0,0 +1,25 @@
+/**
+	@file name_table.cc
+
+	Implementation of the methods for the NameTable class
+*/
+
+#include <string>
+#include <string_view>
+#include "name_table.h"
+
+int NameTable::Intern(std::string_view name) {
+	auto it = ids.find(name);
+	if (it != ids.end()) {
+		return it->second;
+	}
+	int id = (int) names.size();
+	names.emplace_back(name);
+	ids.emplace(names.back(), id);
+	return id;
+}
+
+int NameTable::Find(std::string_view name) const {
+	auto it = ids.find(name);
+	return (it == ids.end()) ? -1 : it->second;
+}
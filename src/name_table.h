@@ -0,0 +1,61 @@
+/**
+	@file name_table.h
+
+	Header file for the NameTable class
+*/
+
+#ifndef SRC_NAME_TABLE_H
+#define SRC_NAME_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+
+/**
+	@brief Class that interns names, giving each distinct name a dense integer ID.
+
+	Names are interned once as they are loaded, after which they are
+	compared as IDs. IDs count up from `0` in the order names are first
+	interned, so they can index arrays directly.
+*/
+class NameTable {
+public:
+	NameTable() = default;
+
+	// A copy's keys would still view the original's names, so a table can
+	// only be moved, which keeps the names where they are
+	NameTable(const NameTable&) = delete;
+	NameTable& operator=(const NameTable&) = delete;
+	NameTable(NameTable&&) = default;
+	NameTable& operator=(NameTable&&) = default;
+
+	/**
+		@brief Return the ID of a name, giving it the next ID if it is new.
+	*/
+	int Intern(std::string_view name);
+
+	/**
+		@brief Return the ID of a name, or `-1` if it has not been interned.
+	*/
+	int Find(std::string_view name) const;
+
+	/**
+		@brief Return the name with the given ID.
+	*/
+	const std::string& get_name(int id) const { return names[id]; }
+
+	/**
+		@brief Return the number of distinct names.
+	*/
+	int size() const { return (int) names.size(); }
+
+private:
+	/// The names in order of their IDs; a deque never moves them, so `ids` can refer to them.
+	std::deque<std::string> names;
+
+	/// The ID of each name.
+	std::unordered_map<std::string_view, int> ids;
+};
+
+#endif
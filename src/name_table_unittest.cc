@@ -0,0 +1,47 @@
+/**
+	@file name_table_unittest.cc
+
+	Unit test for the NameTable class
+*/
+
+#include <string>
+#include <utility>
+#include <type_traits>
+#include "gtest/gtest.h"
+#include "name_table.h"
+
+/// Test that each distinct name gets the next ID and keeps it.
+TEST(NameTableTest, NameTableIntern) {
+	NameTable table;
+	EXPECT_EQ(table.Intern("D"), 0);
+	EXPECT_EQ(table.Intern("R"), 1);
+	EXPECT_EQ(table.Intern(std::string("D")), 0);
+	EXPECT_EQ(table.size(), 2);
+	EXPECT_EQ(table.Find("R"), 1);
+	EXPECT_EQ(table.Find("I"), -1);
+
+	// interning many names keeps the earlier ones in place
+	const std::string& d = table.get_name(0);
+	for (int i = 0; i < 1000; i++) {
+		table.Intern("Party " + std::to_string(i));
+	}
+	EXPECT_EQ(&table.get_name(0), &d);
+	EXPECT_EQ(table.Intern("Party 999"), 1001);
+}
+
+/// Test that a table can be moved but not copied, and still finds its names after a move.
+TEST(NameTableTest, NameTableMove) {
+	static_assert(!std::is_copy_constructible<NameTable>::value, "a copy would view the original's names");
+	static_assert(!std::is_copy_assignable<NameTable>::value, "a copy would view the original's names");
+
+	NameTable moved;
+	{
+		NameTable table;
+		table.Intern("D");
+		table.Intern("R");
+		moved = std::move(table);
+	}
+	EXPECT_EQ(moved.Find("R"), 1);
+	EXPECT_EQ(moved.Intern("D"), 0);
+	EXPECT_EQ(moved.get_name(1), "R");
+}
@@ -0,0 +1,112 @@
+/**
+	@file object_pool.h
+
+	Header file for the ObjectPool class template
+*/
+
+#ifndef SRC_OBJECT_POOL_H
+#define SRC_OBJECT_POOL_H
+
+#include <vector>
+#include <memory>			// allocator
+#include <new>				// placement new
+#include <utility>			// forward
+#include <type_traits>		// is_trivially_destructible
+
+/**
+	@brief Class template that owns objects of type T allocated in blocks.
+
+	Objects are constructed in place in blocks that double in size, so
+	creating n objects takes O(log n) allocations. The objects are never
+	freed one at a time; they are all destroyed and their blocks freed
+	together when the pool is cleared or destroyed. Pointers returned by
+	New stay valid until then.
+*/
+template <typename T>
+class ObjectPool {
+public:
+	/**
+		@brief ObjectPool's constructor.
+
+		@param first_block The number of objects that fit in the first block.
+	*/
+	explicit ObjectPool(int first_block=16) : next_block(first_block < 1 ? 1 : first_block) {}
+
+	/**
+		@brief ObjectPool's destructor.
+
+		Destroy every object in the pool.
+	*/
+	~ObjectPool() { Clear(); }
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	/**
+		@brief Construct an object in the pool.
+
+		@param args The arguments passed to T's constructor.
+
+		@return A pointer to the new object, owned by the pool.
+	*/
+	template <typename... Args>
+	T* New(Args&&... args) {
+		if (blocks.empty() || used == blocks.back().size) {
+			blocks.push_back({std::allocator<T>().allocate(next_block), next_block});
+			next_block *= 2;
+			used = 0;
+		}
+		T* object = blocks.back().first + used;
+		new (object) T(std::forward<Args>(args)...);
+		used++;
+		total_objects++;
+		return object;
+	}
+
+	/**
+		@brief Destroy every object in the pool and free its blocks.
+	*/
+	void Clear() {
+		for (int b = (int) blocks.size() - 1; b >= 0; b--) {
+			int count = (b == (int) blocks.size() - 1) ? used : blocks[b].size;
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				for (int i = count - 1; i >= 0; i--) {
+					blocks[b].first[i].~T();
+				}
+			}
+			std::allocator<T>().deallocate(blocks[b].first, blocks[b].size);
+		}
+		blocks.clear();
+		used = 0;
+		total_objects = 0;
+	}
+
+	/**
+		@brief Return the number of objects in the pool.
+	*/
+	int size() { return total_objects; }
+
+private:
+	/// A block of storage for objects.
+	struct Block {
+		/// The first object in the block.
+		T* first;
+
+		/// The number of objects that fit in the block.
+		int size;
+	};
+
+	/// The blocks allocated so far; only the last one has free space.
+	std::vector<Block> blocks;
+
+	/// The number of objects constructed in the last block.
+	int used{0};
+
+	/// The number of objects that fit in the next block to be allocated.
+	int next_block;
+
+	/// The number of objects in the pool.
+	int total_objects{0};
+};
+
+#endif
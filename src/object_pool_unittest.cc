@@ -0,0 +1,57 @@
+/**
+	@file object_pool_unittest.cc
+
+	Unit test for the ObjectPool class template
+*/
+
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "object_pool.h"
+#include "candidate.h"
+
+namespace {
+
+/// The number of Counted objects that have been constructed but not destroyed.
+int live_objects = 0;
+
+/// A type that counts how many of its objects are alive.
+struct Counted {
+	explicit Counted(int v) : value(v) { live_objects++; }
+	~Counted() { live_objects--; }
+	int value;
+};
+
+}  // namespace
+
+/// Test that objects keep their address and value as the pool grows.
+TEST(ObjectPoolTest, ObjectPoolNew) {
+	ObjectPool<Candidate> pool(2);
+	std::vector<Candidate*> candidates;
+	for (int i = 0; i < 100; i++) {
+		candidates.push_back(pool.New("Candidate " + std::to_string(i), "P"));
+	}
+	EXPECT_EQ(pool.size(), 100);
+	for (int i = 0; i < 100; i++) {
+		EXPECT_EQ(candidates[i]->get_name(), "Candidate " + std::to_string(i));
+	}
+}
+
+/// Test that every object is destroyed when the pool is cleared or destroyed.
+TEST(ObjectPoolTest, ObjectPoolClear) {
+	{
+		ObjectPool<Counted> pool(1);
+		for (int i = 0; i < 10; i++) {
+			EXPECT_EQ(pool.New(i)->value, i);
+		}
+		EXPECT_EQ(live_objects, 10);
+		pool.Clear();
+		EXPECT_EQ(live_objects, 0);
+		EXPECT_EQ(pool.size(), 0);
+
+		pool.New(1);
+		pool.New(2);
+		EXPECT_EQ(live_objects, 2);
+	}
+	EXPECT_EQ(live_objects, 0);
+}
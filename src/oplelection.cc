@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <utility>
 #include <iostream>
 #include "oplelection.h"
 
@@ -23,40 +24,28 @@ OPLElection::OPLElection(std::vector<std::vector<std::string>> data, std::string
 
     // Convert candidate strings to Candidate instances
     for (int i=0; i<total_candidates; i++) {
-        // Store candidate's name and party in temp variables
-        std::string cand_name = data[2][2*i];
-        std::string cand_party = data[2][2*i+1];
-
-        // Search parties vector for whether candidate's party is already accounted for in the election
-        auto it = std::find_if(parties.begin(), parties.end(), [cand_party](Party* p){ return p->get_name() == cand_party; });
-        Party* party;
-        if (it == parties.end()) {
-            // If not, create a party under that name and set party to that party name
-            parties.push_back(new Party(cand_party));
+        // Intern the candidate's party name; a name not seen before gets the next index and a new party
+        int party_id = party_names.Intern(data[2][2*i+1]);
+        if (party_id == total_parties) {
+            parties.push_back(party_pool.New(party_names.get_name(party_id)));
             total_parties++;
-            party = parties.back();
-        } else {
-            // If so, set party to that party name
-            party = *it;
         }
 
-        candidates.push_back(new Candidate(cand_name, cand_party)); // Add candidate to candidates vector
-        party->AddCandidateIndex(i); // Add candidate index to party
-    }
-
-    // Convert ballot strings to Ballot instances
-    for (int i=0; i<total_ballots; i++) {
-        ballots.push_back(new Ballot(data[i+5], i));
+        candidates.push_back(candidate_pool.New(data[2][2*i], data[2][2*i+1])); // Add candidate to candidates vector
+        parties[party_id]->AddCandidateIndex(i); // Add candidate index to party
+        candidate_party.push_back(party_id); // Remember the index of the candidate's party
     }
 
     // Set up the election logger
     SetUpLogger(output_dir);
+
+    // Convert ballot strings to ballots in the ballot store; only first choices are counted
+    first_choice_only = true;
+    ballots = BallotStore(total_candidates);
+    AddBallots(data, 5);
 }
 
 OPLElection::~OPLElection() {
-    for (auto c : candidates) delete c;
-    for (auto b : ballots) delete b;
-    for (auto p : parties) delete p;
     delete logger;
 }
 
@@ -70,30 +59,51 @@ void OPLElection::Run(){
 }
 
 void OPLElection::DistributeBallots(){
+    AuditRankErrors();
 
 	logger->WriteToAuditFile("\nDistributing ballots:\n");
 
-    //loop through each ballot
-    for (int i = 0; i < total_ballots; i++) {
-        //get the index for the chosen candidate from ballot
-        int ind = ballots.at(i)->GetChoice();
-
-        logger->WriteToAuditFile("\nBallot " + std::to_string(ballots.at(i)->get_id()) + " added to candidate " + candidates.at(ind)->get_name() + "\n" );
-
-        //use ind to add a vote to the candidate at index ind
-        candidates.at(ind)->AddBallotId(ballots.at(i)->get_id());
-        //loop through the party to add a vote to the candidate's party
-        for (int k = 0; k < total_parties; k++){
-            //compare candidate party to the party name at parties vector
-            //if they are equal then increment votes to the party
-            if(candidates.at(ind)->get_party() == parties.at(k)->get_name()){
-                parties.at(k)->AddVote();
-                logger->WriteToAuditFile("\nAdding a vote to party: " + parties.at(k)->get_name() + "\n");
-            }
-        }
+    //count the votes of each candidate, then each party's votes from its candidates' votes
+    std::vector<int> candidate_votes(total_candidates, 0);
+    CountFirstChoices(candidate_votes);
+    std::vector<int> party_votes(total_parties, 0);
+    for (int c = 0; c < total_candidates; c++) {
+        candidates[c]->AddVotes(candidate_votes[c]);
+        party_votes[candidate_party[c]] += candidate_votes[c];
+    }
+    for (int k = 0; k < total_parties; k++) {
+        parties[k]->AddVotes(party_votes[k]);
+    }
 
+    if (audit_ballots && !StreamsBallots()) {
+        AuditBallots();
+    } else if (StreamsBallots()) {
+        //without a line per ballot, the audit file records each candidate's votes
+        std::string audit = "\nVote Totals:\n";
+        for (int c = 0; c < total_candidates; c++) {
+            audit += "Candidate " + std::to_string(c) + ": " + std::to_string(candidate_votes[c]) + " votes\n";
+        }
+        logger->WriteToAuditFile(audit);
     }
+}
 
+void OPLElection::AuditBallots(){
+    std::string audit;
+    for (int i = 0; i < ballots.size(); i++) {
+        int ind = ballots.GetChoice(i);
+        if (ind == -1) {
+            continue;
+        }
+        const std::string& party = parties[candidate_party[ind]]->get_name();
+        int weight = ballots.get_weight(i);
+        audit += "\n" + BallotLabel(i) + " added to candidate " + candidates[ind]->get_name() + "\n";
+        if (weight == 1) {
+            audit += "\nAdding a vote to party: " + party + "\n";
+        } else {
+            audit += "\nAdding " + std::to_string(weight) + " votes to party: " + party + "\n";
+        }
+    }
+    logger->WriteToAuditFile(audit);
 }
 
 void OPLElection::GetQuota(){
@@ -105,156 +115,127 @@ void OPLElection::GetQuota(){
 
 void OPLElection::AllocateSeats(){
 	logger->WriteToAuditFile("\nAllocating seats\n");
-    //temp variable to count how many seats have been allocated so far
-    int allocated_seats = 0;
-
-    // integer vector for remainders
-    std::vector<int> remainders;
-
-    //this for loop go through the total votes that parties have
-    //and calculate the number of seats depending on the quota
-    for (int i = 0; i < total_parties; i++){
-        ///divide votes from the party by quota and downcasting it to int
-        //to get a whole number of seats that must be allocated to the party
-
-        int seats = (int) (parties[i]->get_total_votes() / quota);
-        	logger->WriteToAuditFile( parties[i]->get_name() + ": " + std::to_string(parties[i]->get_total_votes())+" divided by "+ std::to_string(quota) + "\n");
-        //store the remainder a party got in an array for second allocation in case not all seats were allocated
-        int remainder = parties[i]->get_total_votes() % quota;
-        // then store the seats in the seats array index that correspond to the party index
-        //first checks if there are enough condidates for the seats
-        if(seats <= parties[i]->get_total_candidates()){
-            //set seats
-            parties[i]->set_total_seats(seats);
-            logger->WriteToAuditFile(parties[i]->get_name() + " got " + std::to_string(parties[i]->get_total_seats()) + "\n");
-            //update temp variable of allocated seats
-            allocated_seats += seats;
+    const char* method_names[] = {"Hare largest remainder", "D'Hondt", "Sainte-Lague"};
+    std::string audit = "Method: " + std::string(method_names[seat_method]) + "\n";
+
+    std::vector<int> votes;
+    std::vector<int> limits;
+    for (int i = 0; i < total_parties; i++) {
+        votes.push_back(parties[i]->get_total_votes());
+        limits.push_back(parties[i]->get_total_candidates());
+    }
+    //give out the seats one at a time to the party with the highest priority
+    SeatAllocator allocator(seat_method, votes, limits, quota);
+    std::vector<SeatAllocator::Step> steps = allocator.Allocate(total_seats, [this](int n) { return ResolveTie(n); });
+
+    if (seat_method == SeatAllocator::kHare) {
+        //the seats each party won with whole quotas, before the remainders
+        std::vector<int> quota_seats(total_parties);
+        for (int i = 0; i < total_parties; i++) {
+            quota_seats[i] = allocator.get_seats(i);
         }
-        else if(seats > parties[i]->get_total_candidates()){
-            //if there are not enought candidated for the seats just allocate seats as there are candidates
-            int tempseats = 0;
-            for (int j = 0; j < parties[i]->get_total_candidates(); j++){
-                tempseats++;
-            }
-            parties[i]->set_total_seats(tempseats);
-            logger->WriteToAuditFile(parties[i]->get_name() + " got " + std::to_string(parties[i]->get_total_seats()) + "\n");
-            allocated_seats += tempseats;
-            remainder = 0;
+        for (const SeatAllocator::Step& step : steps) {
+            quota_seats[step.party]--;
+        }
+        for (int i = 0; i < total_parties; i++) {
+            //a party with more quotas than candidates has no remainder, and
+            //without a quota (fewer ballots than seats) every vote is a remainder
+            int remainder = (quota <= 0) ? votes[i] : (votes[i] / quota > limits[i]) ? 0 : votes[i] % quota;
+            audit += parties[i]->get_name() + ": " + std::to_string(votes[i]) + " divided by " + std::to_string(quota) + "\n";
+            audit += parties[i]->get_name() + " got " + std::to_string(quota_seats[i]) + "\n";
+            audit += "Adding remainder of: " + std::to_string(remainder) + " to a remainder array\n";
         }
-        logger->WriteToAuditFile("Adding remainder of: " + std::to_string(remainder) + " to a remainder array\n");
-        remainders.push_back(remainder);
     }
 
-    // for (int i = 0; i < total_parties; i++){
-    //     std::cout << "party name: " << parties[i]->get_name() << "\n";
-    //     std::cout << "total seats: " << parties[i]->get_total_seats() << "\n";
-    // }
-    
-
-    //if all the seats were not allocated during first iteration then
-    //while not all seats have been allocated:
-    while (allocated_seats < total_seats) {
-        // Vector of next parties to be allocated a seat
-        std::vector<int> next_allocation;
-        int max = -1.0 / 0.0; // negative infinity
-        // Search for the party/parties with the greatest remainder by pushing it/them onto next_allocation
-        for (int i=0; i < total_parties; i++) {
-            if (remainders[i] > max && remainders[i] > 0) {
-                max = remainders[i];
-                next_allocation.clear();
-                next_allocation.push_back(i);
-            } else if (remainders[i] == max) {
-                next_allocation.push_back(i);
+    for (const SeatAllocator::Step& step : steps) {
+        if (!step.tied.empty()) {
+            audit += "Tie for a seat between:";
+            for (int p : step.tied) {
+                audit += " " + parties[p]->get_name();
             }
+            audit += ", resolved with coin toss.\n";
+        }
+        audit += "Seat given to " + parties[step.party]->get_name();
+        if (seat_method == SeatAllocator::kHare) {
+            audit += ", with a remainder of " + std::to_string(step.numerator) + ".\n";
+        } else {
+            audit += ", with " + std::to_string(step.numerator) + " votes divided by " + std::to_string(step.denominator) + ".\n";
         }
+    }
+    logger->WriteToAuditFile(audit);
 
-        // The number of parties to be allocated a seat next
-        int n = (int) next_allocation.size();
-        // rn is from 0 thru n-1, resolving an n-way tie; trivial in case n=1, in which rn=0
-        int rn = ResolveTie(n);
-        // Distribute seat to the winning party
-        int winning_party = next_allocation[rn];
-        parties[winning_party]->set_total_seats( parties[winning_party]->get_total_seats()+1 );
-        // Adjust winning party's remainder accordingly
-        remainders[winning_party] -= quota;
-        // Increment number of allocated seats
-        allocated_seats++;
+    for (int i = 0; i < total_parties; i++) {
+        parties[i]->set_total_seats(allocator.get_seats(i));
     }
-    // for (int i = 0; i < total_parties; i++){
-    //     std::cout << "party name: " << parties[i]->get_name() << "\n";
-    //     std::cout << "total seats: " << parties[i]->get_total_seats() << "\n";
-    // }
 }
 
 void OPLElection::SelectWinners(){
 	logger->WriteToAuditFile("\n Choosing winners\n");
+    std::string audit;
     //loop through parties array to choose winners from a party
     for (int p=0; p < total_parties; p++) {
+        int seats = parties[p]->get_total_seats();
         // Continue if no seats
-        if (parties[p]->get_total_seats() == 0) {
-            continue;
-        }
-        //if seats  are equal to number of candidates there is no need to campare votes
-        if(parties[p]->get_total_candidates() == parties[p]->get_total_seats()){
-            for(int k = 0; k< parties[p]->get_total_candidates(); k++){
-                int c_index = parties[p]->get_candidate_index(k);
-                winners[c_index] = true;
-                logger->WriteToAuditFile(candidates.at(c_index)->get_name() + " has won!\n");
-            }
+        if (seats == 0) {
             continue;
         }
 
-        // Form vector of candidate indices from a single party
-        std::vector<int> cands_in_party;
+        // (-votes, index) keys order the party's candidates from most votes to fewest, then by index
+        std::vector<std::pair<int, int>> keys;
         for (int j=0; j < parties[p]->get_total_candidates(); j++) {
             int cand_idx = parties[p]->get_candidate_index(j);
-            cands_in_party.push_back(cand_idx);
+            keys.emplace_back(-candidates[cand_idx]->get_total_votes(), cand_idx);
         }
 
-        // Sort the cands_in_party vector in descending order
-        for (int j=1; j < (int) cands_in_party.size(); j++) {
-            int key = cands_in_party[j];
-            int i = j-1;
-            while ( i>=0 && candidates[cands_in_party[i]]->get_total_votes() < candidates[key]->get_total_votes() ) {
-                cands_in_party[i+1] =  cands_in_party[i];
-                i--;
+        //if there are at least as many seats as candidates there is no need to compare votes
+        if (seats >= (int) keys.size()) {
+            for (const auto& key : keys) {
+                winners[key.second] = true;
+                audit += candidates[key.second]->get_name() + " has won!\n";
             }
-            cands_in_party[i+1] = key;
+            continue;
         }
 
-
-        // Choose the first however-many candidates as winners
-        for (int j=0; j < parties[p]->get_total_seats(); j++) {
-            int ind = cands_in_party[j]; // Hold index of winning candidate
-            int next = cands_in_party[j+1];
-            // winners[ind] = true;
-            if(candidates[ind]->get_total_votes() == candidates[next]->get_total_votes()){
-            logger->WriteToAuditFile("There is a tie between: " + candidates[ind]->get_name() + " and " + candidates[next]->get_name()+ "\n");
-                int n = ResolveTie();
-                if(n == 1)
-                    continue;
-                else
-                    ind = cands_in_party[next];
-
+        // Find the votes of the candidate at the seat cutoff
+        std::nth_element(keys.begin(), keys.begin() + seats - 1, keys.end());
+        int cutoff = keys[seats - 1].first;
+
+        // Candidates with more votes than the cutoff win, and those with as
+        // many votes as the cutoff share the remaining seats
+        std::vector<std::pair<int, int>> ahead;
+        std::vector<int> tied;
+        for (const auto& key : keys) {
+            if (key.first < cutoff) {
+                ahead.push_back(key);
+            } else if (key.first == cutoff) {
+                tied.push_back(key.second);
             }
-            else if(candidates.at(j)->get_total_votes() == candidates.at(j+1)->get_total_votes() &&
-                    candidates.at(j)->get_total_votes() == candidates.at(j+2)->get_total_votes()){
-     logger->WriteToAuditFile("There is a tie between: " + candidates[ind]->get_name() + ", " + candidates[next + 1]->get_name() + " and " + candidates[ind]->get_name()+ "\n");
-                        int n = ResolveTie(3);
-                        if(n == 1)
-                            continue;
-                        else if(n == 2)
-                            ind = cands_in_party[next];
-                        else
-                            ind = cands_in_party[next + 1];
-
-                    }
-            winners[ind] = true;
-            logger->WriteToAuditFile(candidates.at(ind)->get_name() + " has won!\n");
+        }
+        std::sort(ahead.begin(), ahead.end());
+        std::sort(tied.begin(), tied.end());
+        for (const auto& key : ahead) {
+            winners[key.second] = true;
+            audit += candidates[key.second]->get_name() + " has won!\n";
         }
 
+        int remaining = seats - (int) ahead.size();
+        if ((int) tied.size() > remaining) {
+            audit += "There is a tie between: ";
+            for (int j = 0; j < (int) tied.size(); j++) {
+                audit += (j == 0 ? "" : (j + 1 == (int) tied.size() ? " and " : ", ")) + candidates[tied[j]]->get_name();
+            }
+            audit += "\n";
+            // Draw the winners one at a time from the tied candidates not yet drawn
+            for (int j = 0; j < remaining; j++) {
+                std::swap(tied[j], tied[j + ResolveTie((int) tied.size() - j)]);
+            }
+        }
+        for (int j = 0; j < remaining; j++) {
+            winners[tied[j]] = true;
+            audit += candidates[tied[j]]->get_name() + " has won!\n";
+        }
     }
-   
+    logger->WriteToAuditFile(audit);
 }
 
 void OPLElection::AnnounceResults(){
@@ -280,7 +261,8 @@ void OPLElection::AnnounceResults(){
 						results += "Candidate name: " + cand->get_name() + "\n";
 						results += "Candidate party: " + cand->get_party() + "\n";
 						results += "Candidate votes: " + std::to_string(cand->get_total_votes()) + " ";
-						results += "("+ std::to_string((double) cand->get_total_votes() / (double) total_ballots * 100.0) + "%)\n";
+						double share = (total_ballots > 0) ? (double) cand->get_total_votes() / (double) total_ballots * 100.0 : 0.0;
+						results += "("+ std::to_string(share) + "%)\n";
 						results += "***\n";
 				}
     }
@@ -13,6 +13,8 @@
 #include <vector>
 #include "election.h"
 #include "party.h"
+#include "seat_allocator.h"
+#include "name_table.h"
 
 /**
 	@brief Class that represents an election using Open Party List voting.
@@ -58,6 +60,14 @@ public:
     */
     int get_total_parties(){ return total_parties; }
 
+    /**
+		@brief Set the method of allocating seats to parties.
+
+		@param m The method. Defaults to SeatAllocator::kHare, i.e., the
+		Hare quota with largest remainders.
+    */
+    void set_seat_method(SeatAllocator::Method m) { seat_method = m; }
+
     /**
 		@brief Return the i-th party (0-indexed) in the election.
     */
@@ -100,6 +110,11 @@ private:
   	*/
     void SetUpLogger(std::string output_dir) override;
 
+    /**
+        @brief Write the candidate and party each ballot is added to, to the audit file.
+    */
+    void AuditBallots();
+
 
 
 
@@ -112,8 +127,20 @@ private:
     /// The parties in the election.
     std::vector<Party*> parties;
 
+    /// The pool that owns the Party instances in `parties`.
+    ObjectPool<Party> party_pool;
+
+    /// The index in `parties` of each candidate's party.
+    std::vector<int> candidate_party;
+
+    /// The party names, whose IDs are the parties' indices in `parties`.
+    NameTable party_names;
+
     /// The quota to win a seat.
     int quota;
+
+    /// The method of allocating seats to parties.
+    SeatAllocator::Method seat_method{SeatAllocator::kHare};
 };
 
 #endif //SRC_OPLELECTION_H
@@ -11,6 +11,7 @@
 #include "gtest/gtest.h"
 #include "oplelection.h"
 #include "votingsystem.h"
+#include "test_ballot_rows.h"
 
 /// Test fixture for testing the OPLElection class.
 class OPLElectionTest : public ::testing::Test {
@@ -151,3 +152,45 @@ TEST_F(OPLElectionTest, OPLElectionSelectWinners) {
 	}
 
 }
+
+/// Test that the candidates tied at the seat cutoff share the remaining seats.
+TEST(OPLElectionTieTest, OPLElectionSelectWinnersTie) {
+	std::vector<std::vector<std::string>> data{{"OPL"}, {"5"}, {"A", "D", "B", "D", "C", "D", "E", "D", "F", "I"}, {"3"}, {"13"}};
+	// A has the most votes; B, C and E tie for the remaining seats of D
+	AddBallotRows(data, {{{"1", "", "", "", ""}, 4}, {{"", "1", "", "", ""}, 3}, {{"", "", "1", "", ""}, 3}, {{"", "", "", "1", ""}, 3}});
+	OPLElection e(data, "../testing/");
+	e.DistributeBallots();
+	e.GetQuota();
+	e.AllocateSeats();
+	e.SelectWinners();
+	EXPECT_TRUE(e.is_winner(0));
+	EXPECT_EQ(e.is_winner(1) + e.is_winner(2) + e.is_winner(3), 2);
+	EXPECT_FALSE(e.is_winner(4));
+}
+
+/// Test that an election with fewer ballots than seats, and so a quota of zero, still fills its seats.
+TEST(OPLElectionZeroVoteTest, OPLElectionZeroVote) {
+	OPLElection e(VotingSystem::CsvToData("../testing/opl_testfile_zerovote.csv"), "../testing/");
+	e.Run();
+	EXPECT_EQ(e.get_quota(), 0);
+	int total_winners = 0;
+	for (int i = 0; i < e.get_total_candidates(); i++) {
+		total_winners += e.is_winner(i);
+	}
+	EXPECT_EQ(total_winners, e.get_total_seats());
+}
+
+/// Test that a ballot giving the same rank to more than one candidate is reported and counted for the first of them.
+TEST(OPLElectionRankErrorTest, OPLElectionDuplicateRank) {
+	std::vector<std::vector<std::string>> data = VotingSystem::CsvToData("../testing/opl_testfile.csv");
+	data.resize(5);
+	data[4] = {"2"};
+	AddBallotRows(data, {{{"1", "1", "", "", "", ""}, 1}, {{"", "", "1", "", "", ""}, 1}});
+
+	OPLElection e(data, "../testing/");
+	EXPECT_EQ(e.get_total_rank_errors(), 1);
+	e.Run();
+	EXPECT_EQ(e.get_candidate(0).get_total_votes(), 1);
+	EXPECT_EQ(e.get_candidate(1).get_total_votes(), 0);
+	EXPECT_EQ(e.get_candidate(2).get_total_votes(), 1);
+}
@@ -0,0 +1,36 @@
+/**
+	@file parallel_for.h
+
+	Header file for the ParallelFor function template
+*/
+
+#ifndef SRC_PARALLEL_FOR_H
+#define SRC_PARALLEL_FOR_H
+
+#include <vector>
+#include <thread>
+
+/**
+	@brief Call fn(0) through fn(n-1), each on its own thread.
+
+	fn(0) runs on the calling thread. Returns once every call has finished.
+
+	@param n The number of threads.
+
+	@param fn The function to call with the index of each thread.
+*/
+template <typename Function>
+void ParallelFor(int n, Function fn) {
+	std::vector<std::thread> workers;
+	for (int t = 1; t < n; t++) {
+		workers.emplace_back(fn, t);
+	}
+	if (n > 0) {
+		fn(0);
+	}
+	for (auto& w : workers) {
+		w.join();
+	}
+}
+
+#endif
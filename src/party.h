@@ -11,6 +11,7 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 
 /**
 	@brief Class that represents a party.
@@ -25,7 +26,7 @@ public:
 
 		@param n The name of the party.
 	*/
-	Party(std::string n) { name = n; }
+	Party(std::string n) : name(std::move(n)) {}
 
 	/**
 		@brief Associate a candidate with the party.
@@ -39,10 +40,15 @@ public:
 	*/
 	void AddVote() { total_votes++; }
 
+	/**
+		@brief Indicate that the party has received n votes.
+	*/
+	void AddVotes(int n) { total_votes += n; }
+
 	/**
 		@brief Returns the name of the party.
 	*/
-	std::string get_name() { return name; };
+	const std::string& get_name() { return name; };
 
 	/**
 		@brief Returns the total number of candidates associated with the party.
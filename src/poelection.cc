@@ -21,24 +21,148 @@ POElection::POElection(std::vector<std::vector<std::string>> data, std::string o
 
 	// Convert candidate strings to Candidate instances
 	for (int i=0; i<total_candidates; i++) {
-		candidates.push_back(new Candidate(data[2][2*i], data[2][2*i+1]));
+		candidates.push_back(candidate_pool.New(data[2][2*i], data[2][2*i+1]));
 	}
 
 	// Set up the election logger
 	SetUpLogger(output_dir);
 
-	// Convert ballot strings to Ballot instances
-	for (int i=0; i<total_ballots; i++) {
-			ballots.push_back(new Ballot(data[i+4], i));
-	}
+	// Convert ballot strings to ballots in the ballot store; only first choices are counted
+	first_choice_only = true;
+	ballots = BallotStore(total_candidates);
+	AddBallots(data, 4);
 }
 
 POElection::~POElection() {
-	for (auto c : candidates) delete c;
-	for (auto b : ballots) delete b;
 	delete logger;
 }
 
+void POElection::Run() {
+	DistributeBallots();
+	SelectWinner();
+	AnnounceResults();
+}
+
+void POElection::DistributeBallots() {
+	AuditRankErrors();
+	logger->WriteToAuditFile("\nDistributing ballots:\n");
+
+	// count every candidate's votes in one pass over the first choices
+	std::vector<int> votes(total_candidates, 0);
+	CountFirstChoices(votes);
+	for (int i = 0; i < total_candidates; i++) {
+		candidates[i]->AddVotes(votes[i]);
+	}
+
+	if (audit_ballots && !StreamsBallots()) {
+		AuditBallots();
+	}
+
+	std::string audit = "\nVote Totals:\n";
+	for (int i = 0; i < total_candidates; i++) {
+		audit += "Candidate " + std::to_string(i) + ": " + std::to_string(votes[i]) + " votes\n";
+	}
+	logger->WriteToAuditFile(audit);
+}
+
+void POElection::AuditBallots() {
+	std::string audit;
+	for (int i = 0; i < ballots.size(); i++) {
+		int choice = ballots.GetChoice(i);
+		if (choice == -1) {
+			audit += BallotLabel(i) + " has no candidate chosen and is not counted.\n";
+		} else {
+			audit += BallotLabel(i) + " to Candidate " + std::to_string(choice) + "\n";
+		}
+	}
+	logger->WriteToAuditFile(audit);
+}
+
+void POElection::SelectWinner() {
+	if (total_candidates == 0) {
+		logger->WriteToAuditFile("\nNo candidates are running, so there is no winner.\n");
+		return;
+	}
+
+	// every candidate with the most votes
+	int most = 0;
+	std::vector<int> tied;
+	for (int i = 0; i < total_candidates; i++) {
+		int votes = candidates[i]->get_total_votes();
+		if (tied.empty() || votes > most) {
+			most = votes;
+			tied.assign(1, i);
+		} else if (votes == most) {
+			tied.push_back(i);
+		}
+	}
+
+	int winner = tied[0];
+	if (tied.size() > 1) {
+		// the winner of the coin toss wins the election
+		winner = tied[ResolveTie((int) tied.size())];
+		logger->WriteToAuditFile("\nMost votes tie resolved with coin toss.\n");
+		for (int c : tied) {
+			if (c == winner) {
+				logger->WriteToAuditFile("Candidate " + std::to_string(c) + " wins coin toss.\n");
+			} else {
+				logger->WriteToAuditFile("Candidate " + std::to_string(c) + " loses coin toss.\n");
+			}
+		}
+	}
+	winners[winner] = true;
+	logger->WriteToAuditFile("\nWinner declared with the most votes:\n");
+	logger->WriteToAuditFile("Candidate " + std::to_string(winner) + " with " + std::to_string(most) + " votes.\n");
+}
+
+void POElection::AnnounceResults() {
+	// 'results' string will hold entire message used for outputting to screen and also to audit report
+	std::string results;
+	// ASCII art generated at https://patorjk.com/software/taag
+	// Ivrit font with default settings
+	results += R"(
+  ____   ___    _____ _           _   _               ____                 _ _
+ |  _ \ / _ \  | ____| | ___  ___| |_(_) ___  _ __   |  _ \ ___  ___ _   _| | |_ ___
+ | |_) | | | | |  _| | |/ _ \/ __| __| |/ _ \| '_ \  | |_) / _ \/ __| | | | | __/ __|
+ |  __/| |_| | | |___| |  __/ (__| |_| | (_) | | | | |  _ <  __/\__ \ |_| | | |_\__ \
+ |_|    \___/  |_____|_|\___|\___|\__|_|\___/|_| |_| |_| \_\___||___/\__,_|_|\__|___/)";
+
+	results += "\n\n\nElection type: PO\n";
+	results += "Number of candidates: " + std::to_string(total_candidates) + "\n";
+
+	results += "\n-----Winners-----\n";
+	for (int i = 0; i < total_candidates; i++) {
+		if (winners[i] == true) {
+			Candidate* cand = candidates[i];
+			double share = (total_ballots > 0) ? (double) cand->get_total_votes() / (double) total_ballots * 100.0 : 0.0;
+			results += "***\n";
+			results += "Candidate name: " + cand->get_name() + "\n";
+			results += "Candidate party: " + cand->get_party() + "\n";
+			results += "Candidate votes: " + std::to_string(cand->get_total_votes()) + " ";
+			results += "(" + std::to_string(share) + "%)\n";
+			results += "***\n";
+		}
+	}
+
+	results += "\nTotal number of ballots: " + std::to_string(total_ballots) + "\n";
+
+	results += "\n-----All candidates information-----\n";
+	for (int i = 0; i < total_candidates; i++) {
+		results += "***\n";
+		results += "Candidate name: " + candidates[i]->get_name() + "\n";
+		results += "Candidate party: " + candidates[i]->get_party() + "\n";
+		results += "Candidate votes: " + std::to_string(candidates[i]->get_total_votes()) + "\n";
+		results += "***\n";
+	}
+
+	// write the string to the audit file
+	logger->WriteToAuditFile(results);
+	// write the string to the media report
+	logger->WriteToMediaReport(results);
+	// output string to screen
+	std::cout << results;
+}
+
 void POElection::SetUpLogger(std::string output_dir) {
 	// audit_header holds the header for the audit file
 	std::string audit_header;
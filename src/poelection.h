@@ -38,20 +38,32 @@ public:
 	~POElection();
 
 	/**
-		@brief (Not implemented) Run the election.
+		@brief Run the election: count each candidate's votes, choose the
+		candidate with the most votes as the winner, and announce the results.
 	*/
-	void Run() override {};
+	void Run() override;
 
 private:
 	/**
-		@brief (Not implemented) Distribute all ballots to the corresponding candidates.
+		@brief Count the votes of each candidate from the first choice on each ballot.
 	*/
-	void DistributeBallots() override {};
+	void DistributeBallots() override;
 
 	/**
-		@brief (Not implemented) Announce the results of the election.
+		@brief Write the candidate each ballot is added to, to the audit file.
 	*/
-	void AnnounceResults() override {};
+	void AuditBallots();
+
+	/**
+		@brief Choose the candidate with the most votes as the winner,
+		resolving a tie for the most votes with a coin toss.
+	*/
+	void SelectWinner();
+
+	/**
+		@brief Announce the results of the election.
+	*/
+	void AnnounceResults() override;
 
 	/**
 		@brief Set up the logger for the election.
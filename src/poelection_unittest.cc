@@ -11,6 +11,7 @@
 #include "gtest/gtest.h"
 #include "poelection.h"
 #include "votingsystem.h"
+#include "test_ballot_rows.h"
 
 /// Test fixture for testing the POElection class.
 class POElectionTest : public ::testing::Test {
@@ -46,3 +47,37 @@ TEST_F(POElectionTest, POElectionConstructor) {
 	EXPECT_EQ(elections[2]->get_total_candidates(), 0);
 	EXPECT_EQ(elections[2]->get_total_ballots(), 0);
 }
+
+/// Test that the candidate with the most first choices wins.
+TEST_F(POElectionTest, POElectionRun) {
+	elections[0]->Run();
+	ExpectVotes(elections[0], {3, 2, 0, 2, 1, 1});
+	for (int i = 0; i < elections[0]->get_total_candidates(); i++) {
+		EXPECT_EQ(elections[0]->is_winner(i), i == 0);
+	}
+
+	// with no votes every candidate ties, and the coin toss chooses one winner
+	elections[1]->Run();
+	int winners = 0;
+	for (int i = 0; i < elections[1]->get_total_candidates(); i++) {
+		winners += elections[1]->is_winner(i);
+	}
+	EXPECT_EQ(winners, 1);
+
+	// with no candidates there is no winner
+	elections[2]->Run();
+}
+
+/// Test that ballots repeating or skipping a rank are counted the same way whether or not the ballots are kept.
+TEST_F(POElectionTest, POElectionRankErrors) {
+	for (bool count_only : {false, true}) {
+		POElection e(VotingSystem::CsvToData("../testing/po_testfile_zerovote.csv"), "../testing/");
+		e.set_count_only(count_only);
+		e.AddBallot(std::vector<uint16_t>{1, 1, 0, 0, 0, 0});
+		e.AddBallot(std::vector<uint16_t>{0, 0, 2, 0, 0, 0});
+		e.AddBallot(std::vector<uint16_t>{0, 0, 1, 0, 0, 0});
+		EXPECT_EQ(e.get_total_rank_errors(), 2);
+		e.Run();
+		ExpectVotes(&e, {1, 0, 1, 0, 0, 0});
+	}
+}
@@ -0,0 +1,172 @@
+/**
+	@file rank_scanner.cc
+
+	Implementation of the methods for the RankScanner class
+*/
+
+#include <vector>
+#include <cstdint>
+#include "rank_scanner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RANK_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/// Return whether c ends a field.
+inline bool IsDelimiter(char c) {
+	return c == ',' || c == ' ' || c == '\n';
+}
+
+/// Decode the digits in [first, last) as a rank, or `0` if they are not one.
+inline uint16_t DecodeRank(const char* first, const char* last) {
+	// More than five digits cannot fit in 16 bits
+	if (first == last || last - first > 5) {
+		return 0;
+	}
+	uint32_t value = 0;
+	for (; first < last; first++) {
+		uint32_t digit = (unsigned char) *first - '0';
+		if (digit > 9) {
+			return 0;
+		}
+		value = value * 10 + digit;
+	}
+	return value > UINT16_MAX ? 0 : (uint16_t) value;
+}
+
+/**
+	Finish decoding a row one byte at a time.
+
+	@param start The start of the current field.
+	@param p The first byte that has not been scanned.
+	@param end One past the end of the text.
+	@param ranks The ranks decoded so far.
+
+	@return The start of the next row.
+*/
+const char* FinishRow(const char* start, const char* p, const char* end, std::vector<uint16_t>& ranks) {
+	for (; ; p++) {
+		if (p == end || IsDelimiter(*p)) {
+			ranks.push_back(DecodeRank(start, p));
+			if (p == end) {
+				return end;
+			}
+			if (*p == '\n') {
+				return p + 1;
+			}
+			start = p + 1;
+		}
+	}
+}
+
+#ifdef RANK_SCANNER_X86
+
+/// Decode a row, scanning 16 bytes at a time with SSE2.
+__attribute__((target("sse2")))
+const char* ReadRowSse2(const char* p, const char* end, std::vector<uint16_t>& ranks) {
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i newline = _mm_set1_epi8('\n');
+	const char* start = p;
+
+	while (end - p >= 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, space)), _mm_cmpeq_epi8(block, newline));
+		unsigned mask = (unsigned) _mm_movemask_epi8(hits);
+
+		// Each set bit is a delimiter that ends a field
+		while (mask != 0) {
+			const char* d = p + __builtin_ctz(mask);
+			ranks.push_back(DecodeRank(start, d));
+			if (*d == '\n') {
+				return d + 1;
+			}
+			start = d + 1;
+			mask &= mask - 1;
+		}
+		p += 16;
+	}
+	return FinishRow(start, p, end, ranks);
+}
+
+/// Decode a row, scanning 32 bytes at a time with AVX2.
+__attribute__((target("avx2")))
+const char* ReadRowAvx2(const char* p, const char* end, std::vector<uint16_t>& ranks) {
+	const __m256i comma = _mm256_set1_epi8(',');
+	const __m256i space = _mm256_set1_epi8(' ');
+	const __m256i newline = _mm256_set1_epi8('\n');
+	const char* start = p;
+
+	while (end - p >= 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		__m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, comma), _mm256_cmpeq_epi8(block, space)), _mm256_cmpeq_epi8(block, newline));
+		uint32_t mask = (uint32_t) _mm256_movemask_epi8(hits);
+
+		// Each set bit is a delimiter that ends a field
+		while (mask != 0) {
+			const char* d = p + __builtin_ctz(mask);
+			ranks.push_back(DecodeRank(start, d));
+			if (*d == '\n') {
+				return d + 1;
+			}
+			start = d + 1;
+			mask &= mask - 1;
+		}
+		p += 32;
+	}
+	return FinishRow(start, p, end, ranks);
+}
+
+#endif
+
+}  // namespace
+
+RankScanner::RankScanner(const char* first, const char* last) {
+	cursor = first;
+	end = last;
+	kernel = BestKernel();
+}
+
+bool RankScanner::ReadRow(std::vector<uint16_t>& ranks) {
+	ranks.clear();
+	if (cursor == end) {
+		return false;
+	}
+
+	// An empty line has no fields
+	if (*cursor == '\n') {
+		cursor++;
+		return true;
+	}
+
+	switch (kernel) {
+#ifdef RANK_SCANNER_X86
+		case kAvx2:
+			cursor = ReadRowAvx2(cursor, end, ranks);
+			break;
+		case kSse2:
+			cursor = ReadRowSse2(cursor, end, ranks);
+			break;
+#endif
+		default:
+			cursor = FinishRow(cursor, cursor, end, ranks);
+			break;
+	}
+	return true;
+}
+
+void RankScanner::set_kernel(Kernel k) {
+	kernel = (k <= BestKernel()) ? k : BestKernel();
+}
+
+RankScanner::Kernel RankScanner::BestKernel() {
+#ifdef RANK_SCANNER_X86
+	static const Kernel best = __builtin_cpu_supports("avx2") ? kAvx2 : kSse2;
+	return best;
+#else
+	return kScalar;
+#endif
+}
@@ -0,0 +1,78 @@
+/**
+	@file rank_scanner.h
+
+	Header file for the RankScanner class
+*/
+
+#ifndef SRC_RANK_SCANNER_H
+#define SRC_RANK_SCANNER_H
+
+#include <vector>
+#include <cstdint>
+
+/**
+	@brief Class that decodes ballot rows straight into ranks.
+
+	A ballot row such as `1,3,4,2` or `,,1,2` is scanned for its field
+	separators (`,` and space) and line end 16 or 32 bytes at a time with
+	SSE2 or AVX2, and the digits of each field are decoded in place into
+	a small integer. The widest kernel the processor supports is chosen at
+	runtime, with a scalar kernel as the fallback.
+*/
+class RankScanner {
+public:
+	/// The kernels that can be used to scan for separators.
+	enum Kernel { kScalar, kSse2, kAvx2 };
+
+	/**
+		@brief RankScanner's constructor.
+
+		@param first The start of the ballot rows to scan.
+
+		@param last One past the end of the ballot rows to scan.
+
+		The text is not copied and must outlive the scanner.
+	*/
+	RankScanner(const char* first, const char* last);
+
+	/**
+		@brief Decode the next ballot row.
+
+		@param ranks Cleared, then filled with the rank written in each
+		field of the row. A blank field, or one that is not a number that
+		fits in 16 bits, is decoded as `0`.
+
+		@return `false` if there are no more rows to decode.
+	*/
+	bool ReadRow(std::vector<uint16_t>& ranks);
+
+	/**
+		@brief Return the kernel used to scan for separators.
+	*/
+	Kernel get_kernel() { return kernel; }
+
+	/**
+		@brief Set the kernel used to scan for separators.
+
+		@param k The kernel to use. Falls back to the widest supported
+		kernel if `k` is not supported by the processor.
+	*/
+	void set_kernel(Kernel k);
+
+	/**
+		@brief Return the widest kernel supported by the processor.
+	*/
+	static Kernel BestKernel();
+
+private:
+	/// The start of the next row to be decoded.
+	const char* cursor;
+
+	/// One past the end of the ballot rows.
+	const char* end;
+
+	/// The kernel used to scan for separators.
+	Kernel kernel;
+};
+
+#endif
@@ -0,0 +1,95 @@
+/**
+	@file rank_scanner_benchmark.cc
+
+	Benchmark of the RankScanner kernels against splitting ballot rows
+	into fields with CsvReader and decoding each field
+
+	Usage: `rank_scanner_benchmark [repetitions] [ballot files...]`.
+	Defaults to the ballot files in the `testing` directory.
+*/
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include "csv_reader.h"
+#include "rank_scanner.h"
+#include "ballot.h"
+
+namespace {
+
+/// Return the ballot rows of a file, i.e., the text after its header.
+std::string_view BallotRows(CsvReader& csv) {
+	std::vector<std::string_view> fields;
+	csv.ReadLine(fields);
+	int lines = (!fields.empty() && fields[0] == "OPL") ? 5 : 4;
+	for (int i = 1; i < lines; i++) {
+		csv.SkipLine();
+	}
+	return csv.get_remaining();
+}
+
+/// Time fn over the given number of repetitions and print the result.
+template <typename Function>
+void Time(const std::string& label, int repetitions, std::size_t bytes, Function fn) {
+	uint64_t checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < repetitions; r++) {
+		checksum += fn();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	double mb = (double) bytes * repetitions / (1 << 20);
+	std::cout << "  " << label << ": " << elapsed.count() << " s, "
+		<< mb / elapsed.count() << " MB/s (checksum " << checksum << ")\n";
+}
+
+}  // namespace
+
+/// Main function of the benchmark.
+int main(int argc, char* argv[]) {
+	int repetitions = (argc > 1) ? std::atoi(argv[1]) : 100000;
+	std::vector<std::string> filenames(argv + std::min(argc, 2), argv + argc);
+	if (filenames.empty()) {
+		for (std::string name : {"ir_testfile", "ir_testfile_3waytie", "opl_testfile", "opl_more_seats_than_cand", "po_testfile"}) {
+			filenames.push_back("../testing/" + name + ".csv");
+		}
+	}
+
+	for (const std::string& filename : filenames) {
+		CsvReader csv(filename);
+		std::string_view rows = BallotRows(csv);
+		std::cout << filename << " (" << rows.size() << " bytes of ballot rows)\n";
+
+		Time("CsvReader fields", repetitions, rows.size(), [&]() {
+			CsvReader reader(rows.data(), rows.data() + rows.size());
+			std::vector<std::string_view> fields;
+			uint64_t sum = 0;
+			while (reader.ReadLine(fields)) {
+				for (uint16_t rank : Ballot::ParseRanks(fields)) {
+					sum += rank;
+				}
+			}
+			return sum;
+		});
+
+		const char* names[] = {"RankScanner scalar", "RankScanner SSE2", "RankScanner AVX2"};
+		for (int k = RankScanner::kScalar; k <= RankScanner::BestKernel(); k++) {
+			Time(names[k], repetitions, rows.size(), [&]() {
+				RankScanner scanner(rows.data(), rows.data() + rows.size());
+				scanner.set_kernel((RankScanner::Kernel) k);
+				std::vector<uint16_t> ranks;
+				uint64_t sum = 0;
+				while (scanner.ReadRow(ranks)) {
+					for (uint16_t rank : ranks) {
+						sum += rank;
+					}
+				}
+				return sum;
+			});
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,68 @@
+/**
+	@file rank_scanner_unittest.cc
+
+	Unit test for the RankScanner class
+*/
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "gtest/gtest.h"
+#include "rank_scanner.h"
+
+/// Test fixture for testing the RankScanner class.
+class RankScannerTest : public ::testing::Test {
+public:
+	/// Allocation of resources for test fixture.
+	void SetUp() {
+		// Rows shorter and longer than one SIMD block, ending with and without a newline
+		text = "1,3,4,2\n1,,2,\n\n,,,1\n";
+		text += ",,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,12,,,,,,,,,,,,,,,,,,,3\n";
+		text += "40,39,38,37,36,35,34,33,32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1\n";
+		text += "x,99999,65535,7";
+	}
+
+	/// Decode every row of the text with the given kernel.
+	std::vector<std::vector<uint16_t>> Decode(RankScanner::Kernel kernel) {
+		RankScanner scanner(text.data(), text.data() + text.size());
+		scanner.set_kernel(kernel);
+		std::vector<std::vector<uint16_t>> rows;
+		std::vector<uint16_t> ranks;
+		while (scanner.ReadRow(ranks)) {
+			rows.push_back(ranks);
+		}
+		return rows;
+	}
+
+	/// The ballot rows to decode.
+	std::string text;
+};
+
+/// Test the functionality of RankScanner's ReadRow method.
+TEST_F(RankScannerTest, RankScannerReadRow) {
+	std::vector<std::vector<uint16_t>> rows = Decode(RankScanner::kScalar);
+
+	ASSERT_EQ(rows.size(), 7u);
+	EXPECT_EQ(rows[0], (std::vector<uint16_t>{1, 3, 4, 2}));
+	EXPECT_EQ(rows[1], (std::vector<uint16_t>{1, 0, 2, 0}));
+	EXPECT_TRUE(rows[2].empty());
+	EXPECT_EQ(rows[3], (std::vector<uint16_t>{0, 0, 0, 1}));
+
+	ASSERT_EQ(rows[4].size(), 60u);
+	EXPECT_EQ(rows[4][40], 12);
+	EXPECT_EQ(rows[4][59], 3);
+
+	ASSERT_EQ(rows[5].size(), 40u);
+	for (int i = 0; i < 40; i++) {
+		EXPECT_EQ(rows[5][i], 40 - i);
+	}
+
+	EXPECT_EQ(rows[6], (std::vector<uint16_t>{0, 0, 65535, 7}));
+}
+
+/// Test that every kernel decodes the same ranks.
+TEST_F(RankScannerTest, RankScannerKernels) {
+	std::vector<std::vector<uint16_t>> expected = Decode(RankScanner::kScalar);
+	EXPECT_EQ(Decode(RankScanner::kSse2), expected);
+	EXPECT_EQ(Decode(RankScanner::kAvx2), expected);
+}
@@ -0,0 +1,218 @@
+/**
+	@file ranking_trie.cc
+
+	Implementation of the methods for the RankingTrie class
+*/
+
+#include <vector>
+#include <cstdint>
+#include "ranking_trie.h"
+
+void RankingTrie::Add(const uint16_t* choices, int n, int weight) {
+	if (n == 0) {
+		return;
+	}
+	uint64_t hash = Hash(choices, n);
+	std::size_t slot = FindRanking(choices, n, hash);
+	int p;
+	if (slot < ranking_slots.size() && ranking_slots[slot] >= 0) {
+		p = ranking_slots[slot];
+	} else {
+		// a new ranking; walk down the trie, adding the nodes it does not have yet
+		p = kRoot;
+		for (int i = 0; i < n; i++) {
+			int child = FindChild(p, choices[i]);
+			if (child == -1) {
+				child = (int) nodes.size();
+				nodes.push_back({choices[i], 0, -1, -1, p});
+				LinkChild(p, child);
+			}
+			p = child;
+		}
+		IndexRanking(p, hash);
+	}
+	nodes[p].count += weight;
+	summed = false;
+}
+
+void RankingTrie::Eliminate(const std::vector<bool>& eliminated) {
+	if (!summed) {
+		Sum();
+	}
+	for (int c = 0; c < (int) root_children.size(); c++) {
+		if (eliminated[c] && root_children[c] != -1) {
+			int n = root_children[c];
+			root_children[c] = -1;
+			Splice(n, eliminated);
+		}
+	}
+}
+
+int RankingTrie::FindChild(int p, int c) {
+	if (p == kRoot) {
+		return root_children[c];
+	}
+	if (slots.empty()) {
+		return -1;
+	}
+	std::size_t mask = slots.size() - 1;
+	std::size_t slot = Hash(p, c) & mask;
+	while (slots[slot] >= 0) {
+		const Node& child = nodes[slots[slot]];
+		if (child.parent == p && child.candidate == c) {
+			return slots[slot];
+		}
+		slot = (slot + 1) & mask;
+	}
+	return -1;
+}
+
+void RankingTrie::LinkChild(int p, int n) {
+	nodes[n].parent = p;
+	if (p == kRoot) {
+		root_children[nodes[n].candidate] = n;
+		nodes[n].next_sibling = -1;
+	} else {
+		nodes[n].next_sibling = nodes[p].first_child;
+		nodes[p].first_child = n;
+		Index(n);
+	}
+}
+
+void RankingTrie::Index(int n) {
+	if (2 * (std::size_t) (used_slots + 1) > slots.size()) {
+		// rebuild from the nodes still below the root's children, dropping slots that no longer match
+		slots.assign(slots.empty() ? 64 : 2 * slots.size(), -1);
+		used_slots = 0;
+		for (int m = 0; m < (int) nodes.size(); m++) {
+			if (m != n && nodes[m].parent >= 0) {
+				Index(m);
+			}
+		}
+	}
+	std::size_t mask = slots.size() - 1;
+	std::size_t slot = Hash(nodes[n].parent, nodes[n].candidate) & mask;
+	while (slots[slot] >= 0) {
+		slot = (slot + 1) & mask;
+	}
+	slots[slot] = n;
+	used_slots++;
+}
+
+uint64_t RankingTrie::Hash(const uint16_t* choices, int n) {
+	// FNV-1a over the choices, mixed at the end so the low bits are usable
+	uint64_t hash = 14695981039346656037ULL;
+	for (int i = 0; i < n; i++) {
+		hash = (hash ^ choices[i]) * 1099511628211ULL;
+	}
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+std::size_t RankingTrie::FindRanking(const uint16_t* choices, int n, uint64_t hash) {
+	if (ranking_slots.empty()) {
+		return 0;
+	}
+	std::size_t mask = ranking_slots.size() - 1;
+	std::size_t slot = hash & mask;
+	while (ranking_slots[slot] >= 0 && (ranking_hashes[slot] != hash || !IsRanking(ranking_slots[slot], choices, n))) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+bool RankingTrie::IsRanking(int m, const uint16_t* choices, int n) {
+	// follow the parents back up to the root, matching the choices from last to first
+	for (int i = n - 1; i >= 0; i--) {
+		if (m < 0 || nodes[m].candidate != choices[i]) {
+			return false;
+		}
+		m = nodes[m].parent;
+	}
+	return m == kRoot;
+}
+
+void RankingTrie::IndexRanking(int m, uint64_t hash) {
+	total_rankings++;
+	if (2 * (std::size_t) total_rankings > ranking_slots.size()) {
+		std::vector<int> old_slots;
+		std::vector<uint64_t> old_hashes;
+		old_slots.swap(ranking_slots);
+		old_hashes.swap(ranking_hashes);
+		ranking_slots.assign(old_slots.empty() ? 64 : 2 * old_slots.size(), -1);
+		ranking_hashes.assign(ranking_slots.size(), 0);
+		for (std::size_t s = 0; s < old_slots.size(); s++) {
+			if (old_slots[s] >= 0) {
+				PlaceRanking(old_slots[s], old_hashes[s]);
+			}
+		}
+	}
+	PlaceRanking(m, hash);
+}
+
+void RankingTrie::PlaceRanking(int m, uint64_t hash) {
+	std::size_t mask = ranking_slots.size() - 1;
+	std::size_t slot = hash & mask;
+	while (ranking_slots[slot] >= 0) {
+		slot = (slot + 1) & mask;
+	}
+	ranking_slots[slot] = m;
+	ranking_hashes[slot] = hash;
+}
+
+void RankingTrie::Sum() {
+	// a node is always created after its parent, so walking back from the last
+	// node adds each node's count to its parent's only once it is complete
+	for (int m = (int) nodes.size() - 1; m >= 0; m--) {
+		if (nodes[m].parent >= 0) {
+			nodes[nodes[m].parent].count += nodes[m].count;
+		}
+	}
+	summed = true;
+	// no more rankings are added, so the table of them is let go
+	std::vector<int>().swap(ranking_slots);
+	std::vector<uint64_t>().swap(ranking_hashes);
+	total_rankings = 0;
+}
+
+uint64_t RankingTrie::Hash(int p, int c) {
+	// Fibonacci hashing of the pair, keeping the well-mixed high bits
+	uint64_t key = ((uint64_t) (uint32_t) p << 16) | (uint16_t) c;
+	return (key * 0x9E3779B97F4A7C15ULL) >> 32;
+}
+
+void RankingTrie::Splice(int n, const std::vector<bool>& eliminated) {
+	// ballots that end at n have no more choices and are dropped with it
+	nodes[n].parent = kGone;
+	int child = nodes[n].first_child;
+	while (child != -1) {
+		int next = nodes[child].next_sibling;
+		int c = nodes[child].candidate;
+		if (eliminated[c]) {
+			Splice(child, eliminated);
+		} else if (root_children[c] == -1) {
+			LinkChild(kRoot, child);
+		} else {
+			Merge(root_children[c], child);
+		}
+		child = next;
+	}
+}
+
+void RankingTrie::Merge(int dst, int src) {
+	nodes[dst].count += nodes[src].count;
+	nodes[src].parent = kGone;
+	int child = nodes[src].first_child;
+	while (child != -1) {
+		int next = nodes[child].next_sibling;
+		int match = FindChild(dst, nodes[child].candidate);
+		if (match == -1) {
+			LinkChild(dst, child);
+		} else {
+			Merge(match, child);
+		}
+		child = next;
+	}
+}
@@ -0,0 +1,166 @@
+/**
+	@file ranking_trie.h
+
+	Header file for the RankingTrie class
+*/
+
+#ifndef SRC_RANKING_TRIE_H
+#define SRC_RANKING_TRIE_H
+
+#include <vector>
+#include <cstdint>
+
+/**
+	@brief Class that counts ranked ballots in a prefix trie of their rankings.
+
+	Each node stands for a ranking prefix and holds the number of ballots
+	that start with it, so ballots with the same first choices share nodes.
+	A candidate's votes are the count of the root's child for that
+	candidate.
+
+	Eliminating a candidate splices its child of the root into the root:
+	each of its subtrees is merged with the root's subtree for the same
+	candidate, adding their counts. The cost depends on the number of
+	distinct rankings rather than the number of ballots. Nodes deeper in
+	the trie for eliminated candidates are left alone and spliced once
+	they reach the root.
+
+	The children of each node are linked in a list, which merging walks,
+	and indexed in one hash table keyed by parent and candidate, so a
+	child is found in expected O(1) however many siblings it has. While
+	rankings are added, a second hash table maps each whole ranking to
+	its node, so a ranking seen before costs one lookup instead of a walk
+	down the trie; the counts of the prefixes are summed once, when they
+	are first needed.
+*/
+class RankingTrie {
+public:
+	/**
+		@brief RankingTrie's constructor.
+
+		@param total_candidates The number of candidates.
+	*/
+	RankingTrie(int total_candidates=0) : root_children(total_candidates, -1) {}
+
+	/**
+		@brief Add a ranking to the trie.
+
+		@param choices The candidates in order of preference.
+
+		@param n The number of choices.
+
+		@param weight The number of ballots with this ranking.
+
+		Every ranking must be added before the first call to Eliminate or get_count.
+	*/
+	void Add(const uint16_t* choices, int n, int weight=1);
+
+	/**
+		@brief Splice every eliminated candidate out of the root's children,
+		moving its ballots to their next choices that are still running.
+		Ballots with no such choice are dropped.
+
+		@param eliminated Whether each candidate has been eliminated.
+	*/
+	void Eliminate(const std::vector<bool>& eliminated);
+
+	/**
+		@brief Return the number of ballots whose highest choice still
+		running is candidate c.
+	*/
+	int get_count(int c) {
+		if (!summed) {
+			Sum();
+		}
+		return root_children[c] == -1 ? 0 : nodes[root_children[c]].count;
+	}
+
+	/**
+		@brief Return the number of nodes created for the trie.
+	*/
+	int get_nodes() { return (int) nodes.size(); }
+
+private:
+	/// A ranking prefix.
+	struct Node {
+		/// The candidate last in the prefix.
+		uint16_t candidate;
+		/// The number of ballots starting with the prefix.
+		int count;
+		/// The index of the first child, or `-1`.
+		int first_child;
+		/// The index of the next child of the same parent, or `-1`.
+		int next_sibling;
+		/// The index of the parent, kRoot, or kGone once the node is spliced or merged away.
+		int parent;
+	};
+
+	/// The parent index used for the root, which is not stored in `nodes`.
+	static const int kRoot = -1;
+
+	/// The parent index of a node that is no longer in the trie.
+	static const int kGone = -2;
+
+	/// Return the hash of the child of node p for candidate c.
+	static uint64_t Hash(int p, int c);
+
+	/// Add node n, a child of a node other than the root, to the hash table.
+	void Index(int n);
+
+	/// Return the hash of a whole ranking.
+	static uint64_t Hash(const uint16_t* choices, int n);
+
+	/// Return the slot of the ranking table holding the ranking, or the empty slot where it belongs.
+	std::size_t FindRanking(const uint16_t* choices, int n, uint64_t hash);
+
+	/// Return whether node m is the end of the given ranking.
+	bool IsRanking(int m, const uint16_t* choices, int n);
+
+	/// Add node m, the end of a ranking with the given hash, to the ranking table.
+	void IndexRanking(int m, uint64_t hash);
+
+	/// Put node m, the end of a ranking with the given hash, in the first empty slot for it.
+	void PlaceRanking(int m, uint64_t hash);
+
+	/// Add the count of each node, which so far holds the ballots ending there, to its parent's.
+	void Sum();
+
+	/// Return the child of node p for candidate c, or `-1`.
+	int FindChild(int p, int c);
+
+	/// Make node n a child of node p.
+	void LinkChild(int p, int n);
+
+	/// Move the subtrees of node n, whose candidate was eliminated, to the root.
+	void Splice(int n, const std::vector<bool>& eliminated);
+
+	/// Merge node src into node dst for the same candidate.
+	void Merge(int dst, int src);
+
+	/// The nodes of the trie, other than the root.
+	std::vector<Node> nodes;
+
+	/// The root's child for each candidate, or `-1`.
+	std::vector<int> root_children;
+
+	/// Open-addressed hash table of the nodes below the root's children, `-1` if the slot is empty.
+	/// A node that moves to another parent is indexed again; its old slot no longer matches.
+	std::vector<int> slots;
+
+	/// The number of slots of the hash table in use.
+	int used_slots{0};
+
+	/// Open-addressed hash table of the node ending each ranking added, `-1` if the slot is empty.
+	std::vector<int> ranking_slots;
+
+	/// The hash of the ranking in each slot of `ranking_slots`.
+	std::vector<uint64_t> ranking_hashes;
+
+	/// The number of distinct rankings added.
+	int total_rankings{0};
+
+	/// Whether the count of each node includes the ballots below it.
+	bool summed{true};
+};
+
+#endif
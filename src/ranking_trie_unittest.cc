@@ -0,0 +1,90 @@
+/**
+	@file ranking_trie_unittest.cc
+
+	Unit test for the RankingTrie class
+*/
+
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <algorithm>
+#include "gtest/gtest.h"
+#include "ranking_trie.h"
+
+/// Test that ballots with the same first choices share nodes.
+TEST(RankingTrieTest, RankingTrieAdd) {
+	RankingTrie trie(3);
+	std::vector<uint16_t> a{0, 1, 2};
+	std::vector<uint16_t> b{0, 2};
+	trie.Add(a.data(), 3);
+	trie.Add(a.data(), 2, 4);
+	trie.Add(b.data(), 2);
+	EXPECT_EQ(trie.get_count(0), 6);
+	EXPECT_EQ(trie.get_count(1), 0);
+	EXPECT_EQ(trie.get_count(2), 0);
+	EXPECT_EQ(trie.get_nodes(), 4);
+}
+
+/// Test that eliminating candidates moves their ballots to the next choice still running.
+TEST(RankingTrieTest, RankingTrieEliminate) {
+	RankingTrie trie(4);
+	std::vector<std::vector<uint16_t>> rankings{{0, 1, 2}, {0, 2}, {1, 0, 3}, {2, 1}, {3}, {3, 0, 2}};
+	for (const auto& r : rankings) {
+		trie.Add(r.data(), (int) r.size());
+	}
+	std::vector<bool> eliminated(4, false);
+
+	// {3} is dropped and {3, 0, 2} moves to candidate 0
+	eliminated[3] = true;
+	trie.Eliminate(eliminated);
+	EXPECT_EQ(trie.get_count(0), 3);
+	EXPECT_EQ(trie.get_count(1), 1);
+	EXPECT_EQ(trie.get_count(2), 1);
+	EXPECT_EQ(trie.get_count(3), 0);
+
+	// {1, 0, 3} is dropped, {0, 1, 2} and {0, 2} and {3, 0, 2} move to candidate 2
+	eliminated[0] = true;
+	eliminated[1] = true;
+	trie.Eliminate(eliminated);
+	EXPECT_EQ(trie.get_count(0), 0);
+	EXPECT_EQ(trie.get_count(1), 0);
+	EXPECT_EQ(trie.get_count(2), 4);
+}
+
+/// Test the trie against the first choice still running of every ballot, with many siblings and repeated rankings.
+TEST(RankingTrieTest, RankingTrieRandom) {
+	std::mt19937 rng(1);
+	const int total_candidates = 40;
+	std::vector<uint16_t> order(total_candidates);
+	for (int c = 0; c < total_candidates; c++) {
+		order[c] = (uint16_t) c;
+	}
+	std::vector<std::vector<uint16_t>> pool;
+	for (int r = 0; r < 300; r++) {
+		std::shuffle(order.begin(), order.end(), rng);
+		pool.emplace_back(order.begin(), order.begin() + 1 + rng() % total_candidates);
+	}
+
+	RankingTrie trie(total_candidates);
+	std::vector<std::vector<uint16_t>> ballots;
+	for (int b = 0; b < 3000; b++) {
+		ballots.push_back(pool[rng() % pool.size()]);
+		trie.Add(ballots.back().data(), (int) ballots.back().size());
+	}
+
+	std::vector<bool> eliminated(total_candidates, false);
+	for (int round = 0; round < total_candidates; round++) {
+		std::vector<int> expected(total_candidates, 0);
+		for (const auto& ballot : ballots) {
+			auto choice = std::find_if(ballot.begin(), ballot.end(), [&](uint16_t c) { return !eliminated[c]; });
+			if (choice != ballot.end()) {
+				expected[*choice]++;
+			}
+		}
+		for (int c = 0; c < total_candidates; c++) {
+			ASSERT_EQ(trie.get_count(c), expected[c]);
+		}
+		eliminated[rng() % total_candidates] = true;
+		trie.Eliminate(eliminated);
+	}
+}
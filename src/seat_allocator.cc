@@ -0,0 +1,71 @@
+/**
+	@file seat_allocator.cc
+
+	Implementation of the methods for the SeatAllocator class
+*/
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>		// min, sort
+#include <functional>
+#include "seat_allocator.h"
+
+SeatAllocator::SeatAllocator(Method m, const std::vector<int>& v, const std::vector<int>& l, int q)
+	: method(m), votes(v), limits(l), quota(q), seats(v.size(), 0) {}
+
+std::vector<SeatAllocator::Step> SeatAllocator::Allocate(int total_seats, const std::function<int(int)>& resolve_tie) {
+	int allocated = 0;
+	heap = decltype(heap)();
+	for (int p = 0; p < (int) votes.size(); p++) {
+		if (method == kHare && quota > 0) {
+			seats[p] = std::min(votes[p] / quota, limits[p]);
+			allocated += seats[p];
+		}
+		if (seats[p] < limits[p]) {
+			heap.push(Priority(p));
+		}
+	}
+
+	std::vector<Step> steps;
+	while (allocated < total_seats && !heap.empty()) {
+		// every party tied with the top of the heap takes part in the draw
+		std::vector<Entry> tied{heap.top()};
+		heap.pop();
+		while (!heap.empty() && Tied(heap.top(), tied[0])) {
+			tied.push_back(heap.top());
+			heap.pop();
+		}
+		Step step{tied[0].party, tied[0].numerator, tied[0].denominator, {}};
+		if (tied.size() > 1) {
+			for (const Entry& e : tied) {
+				step.tied.push_back(e.party);
+			}
+			std::sort(step.tied.begin(), step.tied.end());
+			step.party = step.tied[resolve_tie((int) tied.size())];
+			for (const Entry& e : tied) {
+				if (e.party != step.party) {
+					heap.push(e);
+				}
+			}
+		}
+
+		seats[step.party]++;
+		allocated++;
+		if (seats[step.party] < limits[step.party]) {
+			heap.push(Priority(step.party));
+		}
+		steps.push_back(step);
+	}
+	return steps;
+}
+
+SeatAllocator::Entry SeatAllocator::Priority(int p) {
+	switch (method) {
+	case kDHondt:
+		return {votes[p], seats[p] + 1, p};
+	case kSainteLague:
+		return {votes[p], 2 * (int64_t) seats[p] + 1, p};
+	default:
+		return {votes[p] - (int64_t) seats[p] * quota, 1, p};
+	}
+}
@@ -0,0 +1,131 @@
+/**
+	@file seat_allocator.h
+
+	Header file for the SeatAllocator class
+*/
+
+#ifndef SRC_SEAT_ALLOCATOR_H
+#define SRC_SEAT_ALLOCATOR_H
+
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <functional>
+
+/**
+	@brief Class that allocates seats to parties in proportion to their votes.
+
+	Every method gives out seats one at a time to the party with the
+	highest priority, kept in a max-heap, so allocating s seats among p
+	parties takes O(s log p) time. A party's priority depends on its votes
+	and the seats it already has:
+
+	- kHare (largest remainder): each party first gets one seat for every
+	  whole quota of votes; the remaining seats go to the largest
+	  remainders, votes - seats * quota.
+	- kDHondt: votes / (seats + 1).
+	- kSainteLague: votes / (2 * seats + 1).
+
+	Priorities are compared exactly as fractions, by cross-multiplication.
+	A party never gets more seats than it has candidates.
+*/
+class SeatAllocator {
+public:
+	/// The methods of allocating seats.
+	enum Method {
+		/// Hare quota with largest remainders.
+		kHare,
+		/// D'Hondt highest averages.
+		kDHondt,
+		/// Sainte-Laguë highest averages.
+		kSainteLague
+	};
+
+	/// A seat given to a party.
+	struct Step {
+		/// The index of the party.
+		int party;
+		/// The numerator of the party's priority when it got the seat.
+		int64_t numerator;
+		/// The denominator of the party's priority when it got the seat.
+		int64_t denominator;
+		/// The parties tied for the seat in ascending order, or empty if there was no tie.
+		std::vector<int> tied;
+	};
+
+	/**
+		@brief SeatAllocator's constructor.
+
+		@param method The method of allocating seats.
+
+		@param votes The votes of each party.
+
+		@param limits The most seats each party can get, i.e., its number of candidates.
+
+		@param quota The votes needed for a seat, used by kHare only.
+	*/
+	SeatAllocator(Method method, const std::vector<int>& votes, const std::vector<int>& limits, int quota=1);
+
+	/**
+		@brief Give out seats until there are none left or no party can take more.
+
+		With kHare, the seats won by whole quotas are given first and are
+		not returned as steps.
+
+		@param seats The total number of seats.
+
+		@param resolve_tie Called with the number of tied parties; returns
+		the index of the winner among them.
+
+		@return The seats given one at a time, in order.
+	*/
+	std::vector<Step> Allocate(int seats, const std::function<int(int)>& resolve_tie);
+
+	/**
+		@brief Return the number of seats given to party p.
+	*/
+	int get_seats(int p) { return seats[p]; }
+
+private:
+	/// A party waiting for its next seat.
+	struct Entry {
+		int64_t numerator;
+		int64_t denominator;
+		int party;
+	};
+
+	/// Orders entries so the heap's top has the highest priority, then the lowest party index.
+	struct Lower {
+		bool operator()(const Entry& a, const Entry& b) const {
+			int64_t lhs = a.numerator * b.denominator;
+			int64_t rhs = b.numerator * a.denominator;
+			return lhs < rhs || (lhs == rhs && a.party > b.party);
+		}
+	};
+
+	/// Return whether two entries have the same priority.
+	static bool Tied(const Entry& a, const Entry& b) { return a.numerator * b.denominator == b.numerator * a.denominator; }
+
+	/// Return the priority of party p for its next seat.
+	Entry Priority(int p);
+
+	/// The method of allocating seats.
+	Method method;
+
+	/// The votes of each party.
+	std::vector<int> votes;
+
+	/// The most seats each party can get.
+	std::vector<int> limits;
+
+	/// The votes needed for a seat, with kHare.
+	int quota;
+
+	/// The seats given to each party.
+	std::vector<int> seats;
+
+	/// The parties that can take more seats, highest priority first.
+	std::priority_queue<Entry, std::vector<Entry>, Lower> heap;
+};
+
+#endif
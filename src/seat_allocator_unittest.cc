@@ -0,0 +1,73 @@
+/**
+	@file seat_allocator_unittest.cc
+
+	Unit test for the SeatAllocator class
+*/
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "seat_allocator.h"
+
+namespace {
+
+/// Return the seats each party gets.
+std::vector<int> Seats(SeatAllocator& allocator, int parties) {
+	std::vector<int> seats;
+	for (int p = 0; p < parties; p++) {
+		seats.push_back(allocator.get_seats(p));
+	}
+	return seats;
+}
+
+/// A tie breaker for tests that must not have ties.
+int NoTie(int n) {
+	ADD_FAILURE() << "unexpected " << n << "-way tie";
+	return 0;
+}
+
+}  // namespace
+
+/// Test that whole quotas are given first and the remaining seats go to the largest remainders.
+TEST(SeatAllocatorTest, SeatAllocatorHare) {
+	// the last party has two quotas but only one candidate
+	SeatAllocator allocator(SeatAllocator::kHare, {20, 14, 66}, {2, 3, 1}, 33);
+	std::vector<SeatAllocator::Step> steps = allocator.Allocate(3, NoTie);
+	EXPECT_EQ(Seats(allocator, 3), std::vector<int>({1, 1, 1}));
+	ASSERT_EQ(steps.size(), 2u);
+	EXPECT_EQ(steps[0].party, 0);
+	EXPECT_EQ(steps[0].numerator, 20);
+	EXPECT_EQ(steps[1].party, 1);
+}
+
+/// Test the highest averages methods.
+TEST(SeatAllocatorTest, SeatAllocatorDivisors) {
+	std::vector<int> votes{100000, 80000, 30000, 20000};
+	std::vector<int> limits(4, 8);
+
+	SeatAllocator dhondt(SeatAllocator::kDHondt, votes, limits);
+	EXPECT_EQ(dhondt.Allocate(8, NoTie).size(), 8u);
+	EXPECT_EQ(Seats(dhondt, 4), std::vector<int>({4, 3, 1, 0}));
+
+	// the 6th and 7th seats tie at 20000 votes, and both parties get one
+	SeatAllocator sainte_lague(SeatAllocator::kSainteLague, votes, limits);
+	sainte_lague.Allocate(8, [](int n) { return n - 1; });
+	EXPECT_EQ(Seats(sainte_lague, 4), std::vector<int>({3, 3, 1, 1}));
+
+	// a party runs out of candidates and its seats go to the others
+	limits[0] = 2;
+	SeatAllocator limited(SeatAllocator::kDHondt, votes, limits);
+	limited.Allocate(8, [](int n) { return n - 1; });
+	EXPECT_EQ(Seats(limited, 4), std::vector<int>({2, 4, 1, 1}));
+}
+
+/// Test that a tie for a seat is resolved among every tied party.
+TEST(SeatAllocatorTest, SeatAllocatorTie) {
+	SeatAllocator allocator(SeatAllocator::kDHondt, {10, 30, 10, 10}, {1, 1, 1, 1});
+	std::vector<SeatAllocator::Step> steps = allocator.Allocate(2, [](int n) { EXPECT_EQ(n, 3); return 2; });
+	ASSERT_EQ(steps.size(), 2u);
+	EXPECT_EQ(steps[0].party, 1);
+	EXPECT_TRUE(steps[0].tied.empty());
+	EXPECT_EQ(steps[1].party, 3);
+	EXPECT_EQ(steps[1].tied, std::vector<int>({0, 2, 3}));
+	EXPECT_EQ(Seats(allocator, 4), std::vector<int>({0, 1, 0, 1}));
+}
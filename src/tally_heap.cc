@@ -0,0 +1,141 @@
+/**
+	@file tally_heap.cc
+
+	Implementation of the methods for the TallyHeap class
+*/
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <algorithm>			// sort
+#include "tally_heap.h"
+
+TallyHeap::TallyHeap(const std::vector<int>& t) : tallies(t) {
+	for (int tally : t) {
+		total += tally;
+	}
+	Build(fewest);
+	Build(most);
+}
+
+void TallyHeap::Update(int c, int tally) {
+	if (!Contains(c)) {
+		return;
+	}
+	int old_tally = tallies[c];
+	tallies[c] = tally;
+	total += tally - old_tally;
+	Update(fewest, c, old_tally);
+	Update(most, c, old_tally);
+}
+
+void TallyHeap::Remove(int c) {
+	if (!Contains(c)) {
+		return;
+	}
+	total -= tallies[c];
+	Remove(fewest, c);
+	Remove(most, c);
+}
+
+std::vector<int> TallyHeap::MinGroup() {
+	const std::vector<int>& heap = fewest.heap;
+	std::vector<int> group;
+	if (heap.empty()) {
+		return group;
+	}
+	// Every tied candidate is reached through tied parents, starting at the root
+	int least = tallies[heap[0]];
+	std::vector<int> stack{0};
+	while (!stack.empty()) {
+		int p = stack.back();
+		stack.pop_back();
+		if (p >= (int) heap.size() || tallies[heap[p]] != least) {
+			continue;
+		}
+		group.push_back(heap[p]);
+		stack.push_back(2 * p + 1);
+		stack.push_back(2 * p + 2);
+	}
+	std::sort(group.begin(), group.end());
+	return group;
+}
+
+void TallyHeap::Walk(const std::function<bool(int)>& visit) {
+	const std::vector<int>& heap = fewest.heap;
+	// The next candidate in order is always the smallest on the frontier of heap positions,
+	// since each candidate comes after its parent
+	auto later = [&](int p, int q) { return Less(fewest, heap[q], heap[p]); };
+	std::priority_queue<int, std::vector<int>, decltype(later)> frontier(later);
+	if (!heap.empty()) {
+		frontier.push(0);
+	}
+	while (!frontier.empty()) {
+		int p = frontier.top();
+		frontier.pop();
+		if (!visit(heap[p])) {
+			return;
+		}
+		for (int child = 2 * p + 1; child <= 2 * p + 2 && child < (int) heap.size(); child++) {
+			frontier.push(child);
+		}
+	}
+}
+
+void TallyHeap::Build(Order& order) {
+	int n = (int) tallies.size();
+	order.heap.resize(n);
+	order.position.resize(n);
+	for (int c = 0; c < n; c++) {
+		Place(order, c, c);
+	}
+	for (int p = n / 2 - 1; p >= 0; p--) {
+		SiftDown(order, p);
+	}
+}
+
+void TallyHeap::Update(Order& order, int c, int old_tally) {
+	if (order.most_first == (tallies[c] > old_tally)) {
+		SiftUp(order, order.position[c]);
+	} else {
+		SiftDown(order, order.position[c]);
+	}
+}
+
+void TallyHeap::Remove(Order& order, int c) {
+	int p = order.position[c];
+	int last = order.heap.back();
+	order.heap.pop_back();
+	order.position[c] = -1;
+	if (last != c) {
+		Place(order, p, last);
+		SiftUp(order, p);
+		SiftDown(order, order.position[last]);
+	}
+}
+
+void TallyHeap::SiftUp(Order& order, int p) {
+	int c = order.heap[p];
+	while (p > 0 && Less(order, c, order.heap[(p - 1) / 2])) {
+		Place(order, p, order.heap[(p - 1) / 2]);
+		p = (p - 1) / 2;
+	}
+	Place(order, p, c);
+}
+
+void TallyHeap::SiftDown(Order& order, int p) {
+	int c = order.heap[p];
+	int n = (int) order.heap.size();
+	while (2 * p + 1 < n) {
+		int child = 2 * p + 1;
+		if (child + 1 < n && Less(order, order.heap[child + 1], order.heap[child])) {
+			child++;
+		}
+		if (!Less(order, order.heap[child], c)) {
+			break;
+		}
+		Place(order, p, order.heap[child]);
+		p = child;
+	}
+	Place(order, p, c);
+}
@@ -0,0 +1,151 @@
+/**
+	@file tally_heap.h
+
+	Header file for the TallyHeap class
+*/
+
+#ifndef SRC_TALLY_HEAP_H
+#define SRC_TALLY_HEAP_H
+
+#include <vector>
+#include <functional>
+
+/**
+	@brief Class that keeps candidates ordered by their vote tallies.
+
+	A pair of indexed binary heaps over candidate indices, one with the
+	fewest votes on top and one with the most. A candidate's tally can be
+	raised or lowered, and a candidate removed, in O(log n). The candidate
+	with the most votes is found in O(1), and the candidates with the
+	fewest votes are visited in order without scanning every candidate.
+	Candidates with equal tallies are ordered by index, so the results
+	never depend on the order of updates.
+*/
+class TallyHeap {
+public:
+	/**
+		@brief TallyHeap's constructor.
+
+		@param tallies The tally of each candidate. Every candidate starts in the heap.
+	*/
+	TallyHeap(const std::vector<int>& tallies={});
+
+	/**
+		@brief Set the tally of a candidate in the heap.
+
+		@param c The index of the candidate.
+
+		@param tally The candidate's new tally.
+	*/
+	void Update(int c, int tally);
+
+	/**
+		@brief Remove a candidate from the heap.
+
+		@param c The index of the candidate.
+	*/
+	void Remove(int c);
+
+	/**
+		@brief Return the candidate with the fewest votes, or `-1` if the heap is empty.
+	*/
+	int Min() { return fewest.heap.empty() ? -1 : fewest.heap[0]; }
+
+	/**
+		@brief Return the candidate with the most votes, or `-1` if the heap is empty.
+
+		Of the candidates tied for the most votes, the one with the lowest index is returned.
+	*/
+	int Max() { return most.heap.empty() ? -1 : most.heap[0]; }
+
+	/**
+		@brief Return every candidate tied for the fewest votes.
+
+		Takes time proportional to the number of tied candidates.
+
+		@return The tied candidates in ascending order of index.
+	*/
+	std::vector<int> MinGroup();
+
+	/**
+		@brief Visit candidates from the fewest votes to the most, until told to stop.
+
+		Takes O(k log k) time to visit k candidates.
+
+		@param visit Called with each candidate in turn; returns whether to visit the next one.
+	*/
+	void Walk(const std::function<bool(int)>& visit);
+
+	/**
+		@brief Return whether a candidate is in the heap.
+	*/
+	bool Contains(int c) { return c >= 0 && c < (int) fewest.position.size() && fewest.position[c] >= 0; }
+
+	/**
+		@brief Return the tally of a candidate.
+	*/
+	int get_tally(int c) { return tallies[c]; }
+
+	/**
+		@brief Return the number of candidates in the heap.
+	*/
+	int size() { return (int) fewest.heap.size(); }
+
+	/**
+		@brief Return the combined tally of the candidates in the heap.
+	*/
+	long long get_total() { return total; }
+
+private:
+	/// One ordering of the candidates as an indexed binary heap.
+	struct Order {
+		/// Whether the candidate with the most votes is on top, rather than the fewest.
+		bool most_first;
+
+		/// The candidates in heap order.
+		std::vector<int> heap;
+
+		/// The position of each candidate in `heap`, or `-1` if it was removed.
+		std::vector<int> position;
+	};
+
+	/// Return whether candidate a comes before candidate b in an ordering.
+	bool Less(const Order& order, int a, int b) {
+		if (tallies[a] != tallies[b]) {
+			return order.most_first ? tallies[a] > tallies[b] : tallies[a] < tallies[b];
+		}
+		return a < b;
+	}
+
+	/// Fill an ordering with every candidate.
+	void Build(Order& order);
+
+	/// Set the tally of candidate c in an ordering, whose old tally was old_tally.
+	void Update(Order& order, int c, int old_tally);
+
+	/// Remove candidate c from an ordering.
+	void Remove(Order& order, int c);
+
+	/// Move the candidate at heap position p up to its place.
+	void SiftUp(Order& order, int p);
+
+	/// Move the candidate at heap position p down to its place.
+	void SiftDown(Order& order, int p);
+
+	/// Place candidate c at heap position p.
+	void Place(Order& order, int p, int c) { order.heap[p] = c; order.position[c] = p; }
+
+	/// The candidates with the fewest votes first.
+	Order fewest{false, {}, {}};
+
+	/// The candidates with the most votes first.
+	Order most{true, {}, {}};
+
+	/// The tally of each candidate.
+	std::vector<int> tallies;
+
+	/// The combined tally of the candidates in the heap.
+	long long total{0};
+};
+
+#endif
@@ -0,0 +1,140 @@
+/**
+	@file tally_heap_unittest.cc
+
+	Unit test for the TallyHeap class
+*/
+
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include "gtest/gtest.h"
+#include "tally_heap.h"
+
+/// Test that the heap follows tallies as they are raised and lowered.
+TEST(TallyHeapTest, TallyHeapUpdate) {
+	TallyHeap heap({5, 3, 8, 3, 9});
+	EXPECT_EQ(heap.size(), 5);
+	EXPECT_EQ(heap.Min(), 1);
+	EXPECT_EQ(heap.Max(), 4);
+	EXPECT_EQ(heap.get_total(), 28);
+
+	heap.Update(1, 10);
+	EXPECT_EQ(heap.Min(), 3);
+	EXPECT_EQ(heap.Max(), 1);
+	EXPECT_EQ(heap.get_total(), 35);
+	heap.Update(4, 0);
+	EXPECT_EQ(heap.Min(), 4);
+	EXPECT_EQ(heap.get_tally(4), 0);
+
+	heap.Remove(4);
+	heap.Remove(3);
+	EXPECT_FALSE(heap.Contains(3));
+	EXPECT_EQ(heap.size(), 3);
+	EXPECT_EQ(heap.Min(), 0);
+	EXPECT_EQ(heap.Max(), 1);
+	EXPECT_EQ(heap.get_total(), 23);
+
+	// Candidates that were removed are not updated
+	heap.Update(3, -1);
+	EXPECT_EQ(heap.Min(), 0);
+
+	heap.Remove(0);
+	heap.Remove(1);
+	heap.Remove(2);
+	EXPECT_EQ(heap.Min(), -1);
+	EXPECT_EQ(heap.Max(), -1);
+	EXPECT_EQ(heap.get_total(), 0);
+	EXPECT_TRUE(heap.MinGroup().empty());
+}
+
+/// Test that every candidate tied for the fewest votes is found, however many there are.
+TEST(TallyHeapTest, TallyHeapMinGroup) {
+	std::vector<int> tallies(100, 7);
+	tallies[10] = 8;
+	tallies[50] = 9;
+	TallyHeap heap(tallies);
+
+	std::vector<int> group = heap.MinGroup();
+	EXPECT_EQ((int) group.size(), 98);
+	EXPECT_TRUE(std::is_sorted(group.begin(), group.end()));
+	EXPECT_EQ(std::count(group.begin(), group.end(), 10), 0);
+
+	heap.Update(20, 1);
+	heap.Update(30, 1);
+	EXPECT_EQ(heap.MinGroup(), std::vector<int>({20, 30}));
+}
+
+/// Test that candidates are visited from the fewest votes to the most, and the walk stops when told to.
+TEST(TallyHeapTest, TallyHeapWalk) {
+	TallyHeap heap({6, 2, 9, 2, 4, 7});
+	heap.Remove(5);
+
+	std::vector<int> order;
+	heap.Walk([&](int c) {
+		order.push_back(c);
+		return true;
+	});
+	EXPECT_EQ(order, std::vector<int>({1, 3, 4, 0, 2}));
+
+	order.clear();
+	heap.Walk([&](int c) {
+		order.push_back(c);
+		return order.size() < 2;
+	});
+	EXPECT_EQ(order, std::vector<int>({1, 3}));
+}
+
+/// Test the heap against a scan of every tally after random updates.
+TEST(TallyHeapTest, TallyHeapRandom) {
+	srand(1);
+	std::vector<int> tallies(40);
+	for (int& t : tallies) {
+		t = rand() % 20;
+	}
+	TallyHeap heap(tallies);
+	std::vector<bool> removed(tallies.size(), false);
+
+	for (int step = 0; step < 1000; step++) {
+		int c = rand() % (int) tallies.size();
+		if (step % 50 == 49) {
+			heap.Remove(c);
+			removed[c] = true;
+		} else if (!removed[c]) {
+			tallies[c] = rand() % 20;
+			heap.Update(c, tallies[c]);
+		}
+
+		std::vector<int> expected;
+		int most = -1;
+		long long total = 0;
+		for (int i = 0; i < (int) tallies.size(); i++) {
+			if (removed[i]) {
+				continue;
+			}
+			if (most == -1 || tallies[i] > tallies[most]) {
+				most = i;
+			}
+			total += tallies[i];
+			if (!expected.empty() && tallies[i] < tallies[expected[0]]) {
+				expected.clear();
+			}
+			if (expected.empty() || tallies[i] == tallies[expected[0]]) {
+				expected.push_back(i);
+			}
+		}
+		ASSERT_EQ(heap.MinGroup(), expected);
+		ASSERT_EQ(heap.Min(), expected.empty() ? -1 : expected[0]);
+		ASSERT_EQ(heap.Max(), most);
+		ASSERT_EQ(heap.get_total(), total);
+
+		std::vector<int> order;
+		heap.Walk([&](int v) {
+			order.push_back(v);
+			return true;
+		});
+		ASSERT_EQ((int) order.size(), heap.size());
+		for (int k = 1; k < (int) order.size(); k++) {
+			ASSERT_TRUE(tallies[order[k - 1]] < tallies[order[k]] || (tallies[order[k - 1]] == tallies[order[k]] && order[k - 1] < order[k]));
+		}
+	}
+}
@@ -0,0 +1,44 @@
+/**
+	@file test_ballot_rows.h
+
+	Helpers for building ballot data and checking vote totals in the unit tests
+*/
+
+#ifndef SRC_TEST_BALLOT_ROWS_H
+#define SRC_TEST_BALLOT_ROWS_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "gtest/gtest.h"
+#include "election.h"
+
+/**
+	@brief Append ballot rows to parsed ballot data.
+
+	@param data The parsed data of a ballot file, in the same layout as
+	VotingSystem::CsvToData.
+
+	@param rows Each distinct ballot row, with the number of ballots that have it.
+*/
+inline void AddBallotRows(std::vector<std::vector<std::string>>& data, const std::vector<std::pair<std::vector<std::string>, int>>& rows) {
+	for (const auto& row : rows) {
+		data.insert(data.end(), row.second, row.first);
+	}
+}
+
+/**
+	@brief Expect each candidate of an election to have the given number of votes.
+
+	@param election The election whose votes are checked.
+
+	@param expected The votes of each candidate, in order of candidate index.
+*/
+inline void ExpectVotes(Election* election, const std::vector<int>& expected) {
+	ASSERT_EQ(election->get_total_candidates(), (int) expected.size());
+	for (int i = 0; i < election->get_total_candidates(); i++) {
+		EXPECT_EQ(election->get_candidate(i).get_total_votes(), expected[i]);
+	}
+}
+
+#endif
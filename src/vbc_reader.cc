@@ -0,0 +1,137 @@
+/**
+	@file vbc_reader.cc
+
+	Implementation of the methods for the VbcReader class
+*/
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>			// memcmp
+#include <fcntl.h>			// open
+#include <unistd.h>			// close
+#include <sys/mman.h>		// mmap, munmap
+#include <sys/stat.h>		// fstat
+#include "vbc_reader.h"
+
+namespace {
+
+/// The size of the fixed header in bytes.
+const std::size_t kHeaderSize = 24;
+
+}  // namespace
+
+VbcReader::VbcReader(std::string filename) {
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	struct stat st;
+	const unsigned char* mapped = nullptr;
+	if (fstat(fd, &st) == 0 && (std::size_t) st.st_size >= kHeaderSize) {
+		void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) {
+			madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+			length = st.st_size;
+			mapped = static_cast<const unsigned char*>(mapping);
+		}
+	}
+	close(fd);
+	if (mapped == nullptr) {
+		return;
+	}
+
+	// Check the fixed header
+	const char* types[] = {"IR", "OPL", "PO"};
+	int type_code = mapped[4];
+	width = mapped[5];
+	total_candidates = (int) ReadInt(mapped + 8, 4);
+	total_seats = (int) ReadInt(mapped + 12, 4);
+	total_ballots = (int) ReadInt(mapped + 16, 4);
+	std::size_t strings_length = ReadInt(mapped + 20, 4);
+	if (memcmp(mapped, "VBC1", 4) != 0 || type_code > 2 || (width != 1 && width != 2)
+			|| total_candidates < 0 || total_ballots < 0 || strings_length > length - kHeaderSize) {
+		munmap(const_cast<unsigned char*>(mapped), length);
+		return;
+	}
+	type = types[type_code];
+
+	// Read the candidate names and parties from the string table
+	const char* p = reinterpret_cast<const char*>(mapped + kHeaderSize);
+	const char* strings_end = p + strings_length;
+	while (p < strings_end && (int) candidates.size() < 2 * total_candidates) {
+		const char* nul = static_cast<const char*>(memchr(p, '\0', strings_end - p));
+		if (nul == nullptr) {
+			break;
+		}
+		candidates.emplace_back(p, nul - p);
+		p = nul + 1;
+	}
+	if ((int) candidates.size() != 2 * total_candidates) {
+		munmap(const_cast<unsigned char*>(mapped), length);
+		return;
+	}
+
+	begin = mapped;
+	end = begin + length;
+	cursor = begin + kHeaderSize + strings_length;
+}
+
+VbcReader::~VbcReader() {
+	if (begin != nullptr) {
+		munmap(const_cast<unsigned char*>(begin), length);
+	}
+}
+
+std::vector<std::vector<std::string>> VbcReader::GetHeader() {
+	std::vector<std::vector<std::string>> header;
+	if (!is_open()) {
+		return header;
+	}
+	header.push_back({type});
+	header.push_back({std::to_string(total_candidates)});
+	header.push_back(candidates);
+	if (type == "OPL") {
+		header.push_back({std::to_string(total_seats)});
+	}
+	header.push_back({std::to_string(total_ballots)});
+	return header;
+}
+
+VbcReader::ReadStatus VbcReader::ReadBallot(std::vector<uint16_t>& choices) {
+	choices.clear();
+	if (ballots_read == total_ballots) {
+		return kEndOfBallots;
+	}
+	if (end - cursor < width) {
+		return kCorrupt;
+	}
+
+	int total_choices = (int) ReadInt(cursor, width);
+	if (end - cursor < (std::ptrdiff_t) (1 + total_choices) * width) {
+		return kCorrupt;
+	}
+	cursor += width;
+
+	for (int i = 0; i < total_choices; i++) {
+		uint32_t choice = ReadInt(cursor, width);
+		// A choice must name one of the candidates
+		if ((int) choice >= total_candidates) {
+			choices.clear();
+			return kCorrupt;
+		}
+		choices.push_back((uint16_t) choice);
+		cursor += width;
+	}
+	ballots_read++;
+	return kBallotRead;
+}
+
+uint32_t VbcReader::ReadInt(const unsigned char* p, int size) {
+	uint32_t value = 0;
+	for (int i = 0; i < size; i++) {
+		value |= (uint32_t) p[i] << (8 * i);
+	}
+	return value;
+}
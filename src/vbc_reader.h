@@ -0,0 +1,120 @@
+/**
+	@file vbc_reader.h
+
+	Header file for the VbcReader class
+*/
+
+#ifndef SRC_VBC_READER_H
+#define SRC_VBC_READER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+	@brief Class that reads a compiled binary ballot file (`.vbc`).
+
+	The file is memory-mapped and its ballots are handed out one at a
+	time without any parsing. See VbcWriter for the layout of the file.
+*/
+class VbcReader {
+public:
+	/**
+		@brief VbcReader's constructor.
+
+		Map the file into memory and check its header. A file that cannot
+		be opened or is not a valid `.vbc` file is treated as closed.
+
+		@param filename The name of the `.vbc` file to read.
+	*/
+	VbcReader(std::string filename);
+
+	/**
+		@brief VbcReader's destructor.
+
+		Unmap the file.
+	*/
+	~VbcReader();
+
+	VbcReader(const VbcReader&) = delete;
+	VbcReader& operator=(const VbcReader&) = delete;
+
+	/**
+		@brief Return the header of the election.
+
+		@return The header in the same layout as VotingSystem::CsvToData.
+	*/
+	std::vector<std::vector<std::string>> GetHeader();
+
+	/// The result of reading a ballot.
+	enum ReadStatus {
+		/// A ballot was read.
+		kBallotRead,
+		/// Every ballot counted in the header has been read.
+		kEndOfBallots,
+		/// The file ends before the last ballot counted in the header, or
+		/// the ballot names a candidate that does not exist.
+		kCorrupt
+	};
+
+	/**
+		@brief Read the next ballot.
+
+		@param choices Cleared, then filled with the candidate index of each
+		choice on the ballot, in order of preference.
+
+		@return Whether a ballot was read, every ballot has been read, or
+		the rest of the file is truncated or corrupt.
+	*/
+	ReadStatus ReadBallot(std::vector<uint16_t>& choices);
+
+	/**
+		@brief Return whether the file was opened and has a valid header.
+	*/
+	bool is_open() { return begin != nullptr; }
+
+	/**
+		@brief Return the number of ballots in the file.
+	*/
+	int get_total_ballots() { return total_ballots; }
+
+private:
+	/// Read an integer of `size` bytes in little-endian order at `p`.
+	static uint32_t ReadInt(const unsigned char* p, int size);
+
+	/// The start of the mapped file.
+	const unsigned char* begin{nullptr};
+
+	/// One past the end of the mapped file.
+	const unsigned char* end{nullptr};
+
+	/// The start of the next ballot to be read.
+	const unsigned char* cursor{nullptr};
+
+	/// The size of the mapping in bytes.
+	std::size_t length{0};
+
+	/// The election type.
+	std::string type;
+
+	/// The width in bytes of each packed choice.
+	int width{1};
+
+	/// The number of candidates.
+	int total_candidates{0};
+
+	/// The number of seats.
+	int total_seats{0};
+
+	/// The number of ballots.
+	int total_ballots{0};
+
+	/// The name and then the party of each candidate.
+	std::vector<std::string> candidates;
+
+	/// The number of ballots read so far.
+	int ballots_read{0};
+};
+
+#endif
@@ -0,0 +1,109 @@
+/**
+	@file vbc_reader_unittest.cc
+
+	Unit test for the VbcReader and VbcWriter classes
+*/
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include "gtest/gtest.h"
+#include "vbc_reader.h"
+#include "vbc_writer.h"
+
+/// Test fixture for testing the VbcReader and VbcWriter classes.
+class VbcReaderTest : public ::testing::Test {
+public:
+	/// Allocation of resources for test fixture.
+	void SetUp() {
+		header = {{"OPL"}, {"3"}, {"Pike", "D", "Foster", "D", "Smith", "I"}, {"2"}, {"0"}};
+		ballots = {{0}, {2}, {}, {1, 0, 2}};
+	}
+
+	/// Deallocation of resources for test fixture.
+	void TearDown() {
+		std::remove(filename.c_str());
+	}
+
+	/// The name of the file written by the tests.
+	std::string filename = "../testing/vbc_reader_unittest.vbc";
+
+	/// The header of the election.
+	std::vector<std::vector<std::string>> header;
+
+	/// The choices on each ballot.
+	std::vector<std::vector<uint16_t>> ballots;
+};
+
+/// Test that VbcReader reads back what VbcWriter wrote.
+TEST_F(VbcReaderTest, VbcReaderRoundTrip) {
+	VbcWriter writer(filename, header);
+	ASSERT_TRUE(writer.is_open());
+	for (const auto& b : ballots) {
+		EXPECT_TRUE(writer.AddBallot(b));
+	}
+	ASSERT_TRUE(writer.Close());
+
+	VbcReader reader(filename);
+	ASSERT_TRUE(reader.is_open());
+	EXPECT_EQ(reader.get_total_ballots(), 4);
+
+	std::vector<std::vector<std::string>> expected_header = header;
+	expected_header[4][0] = "4";
+	EXPECT_EQ(reader.GetHeader(), expected_header);
+
+	std::vector<uint16_t> choices;
+	for (const auto& b : ballots) {
+		ASSERT_EQ(reader.ReadBallot(choices), VbcReader::kBallotRead);
+		EXPECT_EQ(choices, b);
+	}
+	EXPECT_EQ(reader.ReadBallot(choices), VbcReader::kEndOfBallots);
+}
+
+/// Test that VbcReader rejects files that are not valid.
+TEST_F(VbcReaderTest, VbcReaderInvalidFile) {
+	EXPECT_FALSE(VbcReader("../testing/does_not_exist.vbc").is_open());
+	EXPECT_FALSE(VbcReader("../testing/ir_testfile.csv").is_open());
+
+	// A ballot naming a candidate that does not exist is not written
+	{
+		VbcWriter writer(filename, header);
+		EXPECT_FALSE(writer.AddBallot({7}));
+		for (const auto& b : ballots) {
+			writer.AddBallot(b);
+		}
+	}
+
+	// A file whose last choice is overwritten with a candidate that does not exist is corrupt
+	std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::ate).seekp(-1, std::ios::end).put(7);
+	std::vector<uint16_t> choices;
+	{
+		VbcReader reader(filename);
+		ASSERT_TRUE(reader.is_open());
+		for (int i = 0; i < 3; i++) {
+			EXPECT_EQ(reader.ReadBallot(choices), VbcReader::kBallotRead);
+		}
+		EXPECT_EQ(reader.ReadBallot(choices), VbcReader::kCorrupt);
+	}
+
+	// A file that ends before its last ballot is corrupt
+	{
+		std::ifstream in(filename, std::ios::binary);
+		std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.close();
+		std::ofstream(filename, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size() - 2);
+	}
+	VbcReader truncated(filename);
+	ASSERT_TRUE(truncated.is_open());
+	for (int i = 0; i < 3; i++) {
+		EXPECT_EQ(truncated.ReadBallot(choices), VbcReader::kBallotRead);
+	}
+	EXPECT_EQ(truncated.ReadBallot(choices), VbcReader::kCorrupt);
+
+	// An unknown election type
+	VbcWriter writer("../testing/vbc_reader_unittest_bad.vbc", {{"XYZ"}, {"0"}, {}, {"0"}});
+	EXPECT_FALSE(writer.is_open());
+}
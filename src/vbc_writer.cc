@@ -0,0 +1,95 @@
+/**
+	@file vbc_writer.cc
+
+	Implementation of the methods for the VbcWriter class
+*/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "vbc_writer.h"
+
+VbcWriter::VbcWriter(std::string filename, const std::vector<std::vector<std::string>>& header) {
+	if (header.size() < 4 || header[0].empty() || header[1].empty()) {
+		return;
+	}
+
+	// Read the election type and the number of candidates and seats
+	uint8_t type;
+	if (header[0][0] == "IR") {
+		type = 0;
+	} else if (header[0][0] == "OPL") {
+		type = 1;
+	} else if (header[0][0] == "PO") {
+		type = 2;
+	} else {
+		return;
+	}
+	total_candidates = std::stoi(header[1][0]);
+	int total_seats = (type == 1 && !header[3].empty()) ? std::stoi(header[3][0]) : 0;
+	if (total_candidates < 0 || total_candidates > UINT16_MAX || (int) header[2].size() < 2 * total_candidates) {
+		return;
+	}
+	width = (total_candidates <= UINT8_MAX) ? 1 : 2;
+
+	// Build the string table of candidate names and parties
+	std::string strings;
+	for (int i = 0; i < 2 * total_candidates; i++) {
+		strings += header[2][i];
+		strings += '\0';
+	}
+
+	file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return;
+	}
+	file.write("VBC1", 4);
+	WriteInt(type, 1);
+	WriteInt(width, 1);
+	WriteInt(0, 2);
+	WriteInt(total_candidates, 4);
+	WriteInt(total_seats, 4);
+	WriteInt(0, 4);
+	WriteInt(strings.size(), 4);
+	file.write(strings.data(), strings.size());
+}
+
+VbcWriter::~VbcWriter() {
+	if (file.is_open()) {
+		Close();
+	}
+}
+
+bool VbcWriter::AddBallot(const std::vector<uint16_t>& choices) {
+	// A choice must name one of the candidates, or the file could not be read back
+	for (uint16_t choice : choices) {
+		if (choice >= total_candidates) {
+			return false;
+		}
+	}
+
+	WriteInt(choices.size(), width);
+	for (uint16_t choice : choices) {
+		WriteInt(choice, width);
+	}
+	total_ballots++;
+	return true;
+}
+
+bool VbcWriter::Close() {
+	// Fill in the number of ballots
+	file.seekp(16);
+	WriteInt(total_ballots, 4);
+	bool ok = file.good();
+	file.close();
+	return ok;
+}
+
+void VbcWriter::WriteInt(uint32_t value, int size) {
+	char bytes[4];
+	for (int i = 0; i < size; i++) {
+		bytes[i] = (char) ((value >> (8 * i)) & 0xFF);
+	}
+	file.write(bytes, size);
+}
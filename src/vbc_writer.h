@@ -0,0 +1,95 @@
+/**
+	@file vbc_writer.h
+
+	Header file for the VbcWriter class
+*/
+
+#ifndef SRC_VBC_WRITER_H
+#define SRC_VBC_WRITER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+/**
+	@brief Class that writes a compiled binary ballot file (`.vbc`).
+
+	A `.vbc` file holds the same election as one or more CSV ballot files,
+	but with the ballots already decoded. It starts with a fixed header:
+
+	- the magic bytes `VBC1`
+	- the election type (`0` IR, `1` OPL, `2` PO) and the width in bytes
+	  of each packed integer (`1` or `2`), one byte each, then two bytes
+	  of padding
+	- the number of candidates, seats and ballots, and the length of the
+	  string table, as little-endian 32-bit integers
+
+	The string table follows, with the name and then the party of each
+	candidate, each terminated by `\0`. Each ballot is then packed as its
+	number of choices followed by the candidate index of each choice, in
+	order of preference.
+*/
+class VbcWriter {
+public:
+	/**
+		@brief VbcWriter's constructor.
+
+		Create the file and write its header. The number of ballots in the
+		header is filled in by Close().
+
+		@param filename The name of the `.vbc` file to create.
+
+		@param header The parsed header of the election's ballot file, in
+		the same layout as VotingSystem::CsvToData.
+	*/
+	VbcWriter(std::string filename, const std::vector<std::vector<std::string>>& header);
+
+	/**
+		@brief VbcWriter's destructor.
+
+		Close the file if it has not been closed yet.
+	*/
+	~VbcWriter();
+
+	/**
+		@brief Append a ballot to the file.
+
+		@param choices The candidate index of each choice on the ballot,
+		in order of preference.
+
+		@return `false`, without writing the ballot, if a choice names a
+		candidate that does not exist.
+	*/
+	bool AddBallot(const std::vector<uint16_t>& choices);
+
+	/**
+		@brief Fill in the number of ballots and close the file.
+
+		@return Whether the whole file was written successfully.
+	*/
+	bool Close();
+
+	/**
+		@brief Return whether the header was valid and the file was created.
+	*/
+	bool is_open() { return file.is_open(); }
+
+private:
+	/// Write an integer of `size` bytes in little-endian order.
+	void WriteInt(uint32_t value, int size);
+
+	/// The file stream for the `.vbc` file.
+	std::ofstream file;
+
+	/// The width in bytes of each packed choice.
+	int width{1};
+
+	/// The number of candidates.
+	int total_candidates{0};
+
+	/// The number of ballots written so far.
+	uint32_t total_ballots{0};
+};
+
+#endif
@@ -7,15 +7,123 @@
 */
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint>
 #include <iostream>
+#include <cstdio>
 #include <fstream>
 #include <algorithm>
+#include <iterator>
+#include <atomic>
+#include <thread>
+#include <memory>
 #include <boost/tokenizer.hpp>
 #include "votingsystem.h"
+#include "csv_reader.h"
+#include "rank_scanner.h"
+#include "vbc_reader.h"
+#include "vbc_writer.h"
+#include "ballot.h"
 #include "irelection.h"
 #include "oplelection.h"
 #include "poelection.h"
+#include "parallel_for.h"
+
+namespace {
+
+/// The least number of bytes of ballot rows given to each thread when the
+/// number of threads is chosen automatically.
+const std::size_t kMinChunkBytes = 1 << 20;
+
+/// The number of bytes of ballot rows decoded by one thread at a time when
+/// an election is created. Bounds the memory of the decoded ballots that
+/// are waiting to be added.
+const std::size_t kChunkBytes = 1 << 20;
+
+/// A newline-aligned chunk of the ballot rows of a file.
+struct Chunk {
+	/// The index of the file.
+	int file;
+
+	/// The ballot rows.
+	std::string_view rows;
+
+	/// Whether this is the last chunk of the file.
+	bool last;
+};
+
+/// The ballots decoded from ballot rows, ready to be added to an election in order.
+struct DecodedBallots {
+	/// The choices of every ballot, one ballot after another.
+	std::vector<uint16_t> choices;
+
+	/// The index in `choices` where each ballot ends.
+	std::vector<std::size_t> ends;
+
+	/// Whether the ranks of each ballot were valid, repeated a rank or skipped one.
+	std::vector<Ballot::RankStatus> statuses;
+};
+
+/// Decode ballot rows into choices, skipping blank lines.
+void DecodeRows(std::string_view rows, DecodedBallots& decoded) {
+	RankScanner scanner(rows.data(), rows.data() + rows.size());
+	std::vector<uint16_t> ranks;
+	std::vector<uint16_t> choices;
+	while (scanner.ReadRow(ranks)) {
+		if (!ranks.empty()) {
+			decoded.statuses.push_back(Ballot::RanksToChoices(ranks, choices));
+			decoded.choices.insert(decoded.choices.end(), choices.begin(), choices.end());
+			decoded.ends.push_back(decoded.choices.size());
+		}
+	}
+}
+
+/**
+	Pass each ballot of a compiled ballot file to add(), up to the number
+	of ballots in the file's header.
+
+	@param declared Set to the number of ballots in the file's header.
+
+	@return The number of ballots read, or `-1` if the file is corrupt.
+*/
+template <typename Function>
+int ReadCompiled(const std::string& filename, int& declared, Function add) {
+	VbcReader vbc(filename);
+	declared = vbc.get_total_ballots();
+	std::vector<uint16_t> choices;
+	int read = 0;
+	VbcReader::ReadStatus status;
+	while ((status = vbc.ReadBallot(choices)) == VbcReader::kBallotRead) {
+		add(choices);
+		read++;
+	}
+	if (status == VbcReader::kCorrupt) {
+		std::cout << filename << " is corrupt after ballot " << read << "!\n";
+		return -1;
+	}
+	return read;
+}
+
+/// Copy the fields of a line into strings, removing any brackets that the
+/// reader left inside a field.
+std::vector<std::string> CopyFields(const std::vector<std::string_view>& fields) {
+	std::vector<std::string> line;
+	line.reserve(fields.size());
+
+	for (std::string_view field : fields) {
+		std::string entry(field);
+		if (entry.find_first_of("[]()") != std::string::npos) {
+			entry.erase(remove_if(entry.begin(), entry.end(), [](char c) {
+				return c == '[' || c == ']' || c == '(' || c == ')';
+			}), entry.end());
+		}
+		line.push_back(std::move(entry));
+	}
+	return line;
+}
+
+}  // namespace
 
 std::vector<std::string> VotingSystem::ParseFileNames(std::string user_input) {
 	std::vector<std::string> filenames;
@@ -41,8 +149,8 @@ bool VotingSystem::ValidateFileName(std::string filename) {
 		return false;
 	}
 
-	// Check if the file extension is csv
-	if (filename.length() < 4 || filename.substr(filename.length() - 4) != ".csv") {
+	// Check if the file extension is csv, or vbc for a compiled ballot file
+	if (filename.length() < 4 || (filename.substr(filename.length() - 4) != ".csv" && !IsCompiled(filename))) {
 		std::cout << filename << " is not in csv format!\n";
 		return false;
 	}
@@ -57,84 +165,368 @@ bool VotingSystem::ValidateFileName(std::string filename) {
 }
 
 void VotingSystem::StartAnElection() {
-	std::vector<std::vector<std::string>> data = AggregateData(filenames);
-	Election* election;
-
-	// Read the election type
-	if (data[0][0] == "IR") {
-		election = new IRElection(data);
-	} else if (data[0][0] == "OPL") {
-		election = new OPLElection(data);
-	} else if (data[0][0] == "PO") {
-		election = new POElection(data);
+	Election* election = CreateElection(filenames, "", deduplicate, count_only, num_threads);
+	if (election == nullptr) {
+		std::cout << "Unrecognized election type!\n";
+		return;
 	}
 	election->Run();
 	return;
 }
 
-std::vector<std::vector<std::string>> VotingSystem::CsvToData(std::string filename) {
-	std::vector<std::vector<std::string>> data;
-	std::fstream csv(filename, std::ios::in);
-	std::string csvline;
-
-	while (getline(csv, csvline)) {
-		std::vector<std::string> line;
-
-		typedef boost::tokenizer<boost::char_separator<char>> Tokenizer;
-		boost::char_separator<char> sep(", ", "", boost::keep_empty_tokens);
-		Tokenizer tok(csvline, sep);
-
-		for (Tokenizer::iterator beg = tok.begin(); beg != tok.end(); beg++) {
-			std::string entry = *beg;
-			entry.erase(remove(entry.begin(), entry.end(), '['), entry.end());
-			entry.erase(remove(entry.begin(), entry.end(), ']'), entry.end());
-			entry.erase(remove(entry.begin(), entry.end(), '('), entry.end());
-			entry.erase(remove(entry.begin(), entry.end(), ')'), entry.end());
-			line.push_back(entry);
+Election* VotingSystem::CreateElection(std::vector<std::string> filenames, std::string output_dir, bool deduplicate, bool count_only, int num_threads) {
+	// Read the headers first to find the total number of ballots
+	std::vector<std::vector<std::string>> header = ReadHeaders(filenames);
+	if (header.empty()) {
+		return nullptr;
+	}
+
+	// Construct the election from the header alone
+	Election* election;
+	if (header[0][0] == "IR") {
+		election = new IRElection(header, output_dir);
+	} else if (header[0][0] == "OPL") {
+		election = new OPLElection(header, output_dir);
+	} else if (header[0][0] == "PO") {
+		election = new POElection(header, output_dir);
+	} else {
+		return nullptr;
+	}
+	election->set_deduplicate(deduplicate);
+	election->set_count_only(count_only);
+	election->set_num_threads(num_threads);
+
+	if (!AddBallots(election, filenames, num_threads)) {
+		delete election;
+		return nullptr;
+	}
+	return election;
+}
+
+bool VotingSystem::AddBallots(Election* election, const std::vector<std::string>& filenames, int num_threads) {
+	int total_files = (int) filenames.size();
+	if (num_threads <= 0) {
+		num_threads = (int) std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// The ballot files stay mapped until all of their chunks have been added
+	std::vector<std::unique_ptr<CsvReader>> readers(total_files);
+	std::vector<int> declared(total_files, 0);
+	std::vector<int> rows(total_files, 0);
+	std::vector<Chunk> chunks;
+	std::vector<DecodedBallots> decoded;
+	std::vector<uint16_t> ballot;
+
+	// Decode the waiting chunks concurrently, then add their ballots in order
+	auto flush = [&]() {
+		decoded.assign(chunks.size(), DecodedBallots());
+		ParallelFor((int) chunks.size(), [&](int t) {
+			DecodeRows(chunks[t].rows, decoded[t]);
+		});
+		bool ok = true;
+		for (std::size_t t = 0; t < chunks.size(); t++) {
+			int f = chunks[t].file;
+			const std::vector<uint16_t>& choices = decoded[t].choices;
+			std::size_t start = 0;
+			for (std::size_t k = 0; k < decoded[t].ends.size(); k++) {
+				// Rows beyond the header's count are ignored
+				if (rows[f] == declared[f]) {
+					break;
+				}
+				std::size_t end = decoded[t].ends[k];
+				ballot.assign(choices.begin() + start, choices.begin() + end);
+				election->AddBallotChoices(ballot, decoded[t].statuses[k]);
+				rows[f]++;
+				start = end;
+			}
+			if (chunks[t].last) {
+				readers[f].reset();
+				ok = ok && CheckBallotCount(filenames[f], rows[f], declared[f]);
+			}
+		}
+		chunks.clear();
+		return ok;
+	};
+
+	for (int f = 0; f < total_files; f++) {
+		if (IsCompiled(filenames[f])) {
+			// Compiled ballots are already decoded, so they are streamed straight in
+			// once the ballots of the files before them have been added
+			if (!flush()) {
+				return false;
+			}
+			rows[f] = ReadCompiled(filenames[f], declared[f], [&](const std::vector<uint16_t>& choices) {
+				election->AddBallotChoices(choices);
+			});
+			if (rows[f] < 0 || !CheckBallotCount(filenames[f], rows[f], declared[f])) {
+				return false;
+			}
+			continue;
 		}
 
-		data.push_back(line);
+		// Split the ballot rows into newline-aligned chunks that are decoded
+		// one per thread, a round of chunks at a time
+		readers[f] = std::make_unique<CsvReader>(filenames[f]);
+		declared[f] = std::stoi(ReadHeader(*readers[f]).back()[0]);
+		std::string_view body = readers[f]->get_remaining();
+		std::vector<std::string_view> split = CsvReader::SplitLines(body, (int) (body.size() / kChunkBytes) + 1);
+		for (std::size_t i = 0; i < split.size(); i++) {
+			chunks.push_back({f, split[i], i + 1 == split.size()});
+			if ((int) chunks.size() == num_threads && !flush()) {
+				return false;
+			}
+		}
 	}
-	return data;
+	return flush();
 }
 
-std::vector<std::vector<std::string>> VotingSystem::AggregateData(std::vector<std::string> filenames) {
-	std::vector<std::vector<std::string>> aggregated_data;
+bool VotingSystem::CheckBallotCount(const std::string& filename, int rows, int declared) {
+	// Missing ballots cannot be counted
+	if (rows < declared) {
+		std::cout << filename << " has " << rows << " ballots but its header declares " << declared << "!\n";
+		return false;
+	}
+	return true;
+}
 
-	// Store the number of lines to skip
-	int offset = 0;
-	
-	// Store the total number of ballots
+bool VotingSystem::CompileBallotFile(std::vector<std::string> filenames, std::string vbc_filename) {
+	std::vector<std::vector<std::string>> header = ReadHeaders(filenames);
+	if (header.empty()) {
+		return false;
+	}
+
+	VbcWriter vbc(vbc_filename, header);
+	if (!vbc.is_open()) {
+		std::cout << "Could not create " << vbc_filename << "!\n";
+		return false;
+	}
+
+	// Ballots are copied up to the number in each file's header, as when an election is created
+	std::vector<uint16_t> ballot;
+	std::vector<uint16_t> choices;
+	bool ok = true;
+	for (std::size_t i = 0; ok && i < filenames.size(); i++) {
+		const std::string& filename = filenames[i];
+		int declared;
+		int rows = 0;
+		int rank_errors = 0;
+		if (IsCompiled(filename)) {
+			rows = ReadCompiled(filename, declared, [&](const std::vector<uint16_t>& c) {
+				vbc.AddBallot(c);
+			});
+			ok = rows >= 0;
+		} else {
+			CsvReader csv(filename);
+			declared = std::stoi(ReadHeader(csv).back()[0]);
+			std::string_view body = csv.get_remaining();
+			RankScanner scanner(body.data(), body.data() + body.size());
+			while (ok && rows < declared && scanner.ReadRow(ballot)) {
+				if (ballot.empty()) {
+					continue;
+				}
+				if (Ballot::RanksToChoices(ballot, choices) != Ballot::kRanksValid) {
+					rank_errors++;
+				}
+				if (!vbc.AddBallot(choices)) {
+					std::cout << filename << " ranks a candidate that does not exist on ballot " << rows << "!\n";
+					ok = false;
+				}
+				rows++;
+			}
+		}
+		ok = ok && CheckBallotCount(filename, rows, declared);
+
+		// The compiled file holds only the choices that are counted, so rank errors are reported here
+		if (rank_errors > 0) {
+			std::cout << filename << " has " << rank_errors << " ballots that give the same rank to more than one candidate or skip a rank.\n";
+		}
+	}
+
+	// A file that could not be compiled completely is removed
+	if (!vbc.Close() || !ok) {
+		std::remove(vbc_filename.c_str());
+		return false;
+	}
+	return true;
+}
+
+std::vector<std::vector<std::string>> VotingSystem::ReadHeaders(const std::vector<std::string>& filenames) {
+	std::vector<std::vector<std::string>> header;
 	int total_ballots = 0;
-	
+
 	for (std::size_t i = 0; i < filenames.size(); i++) {
-		std::vector<std::vector<std::string>> data = CsvToData(filenames[i]);
-		
-		aggregated_data.insert(aggregated_data.end(), data.begin() + offset, data.end());
-		
+		std::vector<std::vector<std::string>> file_header;
+		if (IsCompiled(filenames[i])) {
+			file_header = VbcReader(filenames[i]).GetHeader();
+		} else {
+			CsvReader csv(filenames[i]);
+			file_header = ReadHeader(csv);
+		}
+
+		if (file_header.empty()) {
+			return {};
+		}
 		if (i == 0) {
-			if (data[0][0] == "OPL") {
-				offset = 5;
-			} else {
-				offset = 4;
+			header = file_header;
+		} else if (!HeadersMatch(header, file_header)) {
+			std::cout << filenames[i] << " does not match the header of " << filenames[0] << "!\n";
+			return {};
+		}
+		total_ballots += std::stoi(file_header.back()[0]);
+	}
 
-			}
+	if (!header.empty()) {
+		header.back()[0] = std::to_string(total_ballots);
+	}
+	return header;
+}
+
+bool VotingSystem::IsCompiled(const std::string& filename) {
+	return filename.length() >= 4 && filename.substr(filename.length() - 4) == ".vbc";
+}
+
+std::vector<std::vector<std::string>> VotingSystem::ReadHeader(CsvReader& csv) {
+	std::vector<std::vector<std::string>> header;
+	std::vector<std::string_view> fields;
+
+	// The first line holds the election type
+	if (!csv.ReadLine(fields) || fields.empty()) {
+		return header;
+	}
+	header.push_back(std::vector<std::string>(fields.begin(), fields.end()));
+
+	int lines = HeaderLength(header[0][0]);
+	for (int i = 1; i < lines && csv.ReadLine(fields); i++) {
+		header.push_back(std::vector<std::string>(fields.begin(), fields.end()));
+	}
+
+	if ((int) header.size() < lines || header.back().empty()) {
+		header.clear();
+	}
+	return header;
+}
+
+std::vector<std::vector<std::string>> VotingSystem::CsvToData(std::string filename, int num_threads) {
+	std::vector<std::vector<std::string>> data;
+	CsvReader csv(filename);
+	std::vector<std::string_view> fields;
+
+	// Read the header lines in order
+	if (csv.ReadLine(fields)) {
+		data.push_back(CopyFields(fields));
+		int lines = data[0].empty() ? 1 : HeaderLength(data[0][0]);
+		for (int i = 1; i < lines && csv.ReadLine(fields); i++) {
+			data.push_back(CopyFields(fields));
 		}
-		
-		// Accumuate the number of ballots
-		if (data[0][0] == "OPL") {
-			total_ballots += std::stoi(data[4][0]);
-		} else {
-			total_ballots += std::stoi(data[3][0]);
+	}
+
+	// Split the ballot rows into newline-aligned chunks, one per thread
+	std::string_view body = csv.get_remaining();
+	if (num_threads <= 0) {
+		std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+		num_threads = (int) std::min(max_threads, body.size() / kMinChunkBytes + 1);
+	}
+	std::vector<std::string_view> chunks = CsvReader::SplitLines(body, num_threads);
+
+	// Count the rows of each chunk; a prefix sum gives the row each chunk
+	// starts at, so rows (and so ballot IDs) are the same as a sequential parse
+	std::vector<std::size_t> first_row(num_threads + 1, 0);
+	ParallelFor(num_threads, [&](int t) {
+		first_row[t + 1] = CsvReader::CountLines(chunks[t]);
+	});
+	first_row[0] = data.size();
+	for (int t = 0; t < num_threads; t++) {
+		first_row[t + 1] += first_row[t];
+	}
+	data.resize(first_row[num_threads]);
+
+	// Parse each chunk straight into its rows
+	ParallelFor(num_threads, [&](int t) {
+		CsvReader chunk(chunks[t].data(), chunks[t].data() + chunks[t].size());
+		std::vector<std::string_view> chunk_fields;
+		for (std::size_t row = first_row[t]; chunk.ReadLine(chunk_fields); row++) {
+			data[row] = CopyFields(chunk_fields);
 		}
+	});
+
+	return data;
+}
+
+std::vector<std::vector<std::string>> VotingSystem::AggregateData(std::vector<std::string> filenames, int num_threads) {
+	std::vector<std::vector<std::string>> aggregated_data;
+	int total_files = (int) filenames.size();
+	if (total_files == 0) {
+		return aggregated_data;
 	}
 
-	if (aggregated_data[0][0] == "OPL") {
-		aggregated_data[4][0] = std::to_string(total_ballots);
+	// Parse the files concurrently; each worker takes the next unparsed file
+	std::vector<std::vector<std::vector<std::string>>> parsed(total_files);
+	if (total_files == 1) {
+		// A single file is split across the threads instead
+		parsed[0] = CsvToData(filenames[0], num_threads);
 	} else {
-		aggregated_data[3][0] = std::to_string(total_ballots);
+		if (num_threads <= 0) {
+			num_threads = (int) std::max(1u, std::thread::hardware_concurrency());
+		}
+		std::atomic<int> next_file{0};
+		ParallelFor(std::min(num_threads, total_files), [&](int) {
+			for (int i = next_file++; i < total_files; i = next_file++) {
+				parsed[i] = CsvToData(filenames[i], 1);
+			}
+		});
+	}
+
+	// Every file must belong to the same election as the first one
+	for (int i = 0; i < total_files; i++) {
+		if (!HeadersMatch(parsed[0], parsed[i])) {
+			std::cout << filenames[i] << " does not match the header of " << filenames[0] << "!\n";
+			return aggregated_data;
+		}
 	}
 
+	// Store the number of lines to skip
+	int offset = HeaderLength(parsed[0][0][0]);
+
+	// Accumulate the number of ballots and rows
+	int total_ballots = 0;
+	std::size_t total_rows = offset;
+	for (const auto& data : parsed) {
+		total_ballots += std::stoi(data[offset - 1][0]);
+		total_rows += data.size() - offset;
+	}
+
+	// Move the rows in file order so that ballot IDs match a sequential parse
+	aggregated_data.reserve(total_rows);
+	std::move(parsed[0].begin(), parsed[0].begin() + offset, std::back_inserter(aggregated_data));
+	for (auto& data : parsed) {
+		std::move(data.begin() + offset, data.end(), std::back_inserter(aggregated_data));
+		data = {};
+	}
+
+	aggregated_data[offset - 1][0] = std::to_string(total_ballots);
+
 	return aggregated_data;
 }
 
+int VotingSystem::HeaderLength(const std::string& type) {
+	// OPL files have an extra line for the number of seats
+	return (type == "OPL") ? 5 : 4;
+}
+
+bool VotingSystem::HeadersMatch(const std::vector<std::vector<std::string>>& first, const std::vector<std::vector<std::string>>& other) {
+	if (first.empty() || other.empty() || first[0].empty() || other[0].empty()) {
+		return false;
+	}
+	int length = HeaderLength(first[0][0]);
+	if ((int) first.size() < length || (int) other.size() < length) {
+		return false;
+	}
+
+	// Compare the type, candidates and seats, but not the number of ballots
+	for (int i = 0; i < length - 1; i++) {
+		if (first[i] != other[i]) {
+			return false;
+		}
+	}
+	return !other[length - 1].empty();
+}
@@ -12,6 +12,8 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include "election.h"
+#include "csv_reader.h"
 
 /**
  * @brief Class that validates and parses the ballot file.
@@ -28,6 +30,8 @@ public:
 	/**
 	 * @brief Validate the ballot files.
 	 *
+	 * A ballot file must exist and be a CSV file or a compiled `.vbc` file.
+	 *
 	 * @param filename The filename entered by the user.
 	 *
 	 * @return A boolean value indicating whether the ballot file is valid.
@@ -42,20 +46,80 @@ public:
 	/**
 	 * @brief Parse the CSV ballot file.
 	 *
+	 * Compatibility wrapper that copies the fields read by CsvReader into
+	 * strings. Prefer CsvReader where the fields need not outlive the file.
+	 * The ballot rows are split into newline-aligned chunks that are parsed
+	 * concurrently; the result is the same as a sequential parse.
+	 *
 	 * @param filename The name of the ballot file to parse.
 	 *
+	 * @param num_threads The number of threads to parse the ballot rows on.
+	 * Defaults to as many hardware threads as the size of the file warrants.
+	 *
 	 * @return The parsed data from the ballot file.
 	 */
-	static std::vector<std::vector<std::string>> CsvToData(std::string filename);
+	static std::vector<std::vector<std::string>> CsvToData(std::string filename, int num_threads=0);
 
 	/**
 	 * @brief Aggregate data from multiple CSV ballot files.
 	 *
+	 * The files are parsed concurrently and merged in the order given, so
+	 * the result is the same as parsing them one after another. Every file
+	 * must have the same election type, candidates and seats as the first.
+	 *
+	 * @param filenames A vector of ballot filenames.
+	 *
+	 * @param num_threads The number of worker threads. Defaults to the
+	 * number of hardware threads.
+	 *
+	 * @return The aggregated data from the ballot files, or an empty vector
+	 * if the headers of the files do not match.
+	 */
+	static std::vector<std::vector<std::string>> AggregateData(std::vector<std::string> filenames, int num_threads=0);
+
+	/**
+	 * @brief Create an Election by streaming ballot files into it.
+	 *
+	 * Only the headers of the files are parsed up front. The election is
+	 * constructed from the header of the first file, with the number of
+	 * ballots summed over all files, and the ballots are then added to it
+	 * in file order (see AddBallots), so the ballot text is never held in
+	 * memory. Blank lines are skipped, and rows beyond the number of
+	 * ballots in a file's header are ignored.
+	 *
+	 * @param filenames A vector of ballot filenames.
+	 *
+	 * @param output_dir The output directory for the audit file and media report.
+	 *
+	 * @param deduplicate Whether identical ballots are counted once as a
+	 * weighted group (see Election::set_deduplicate).
+	 *
+	 * @param count_only Whether votes are only counted, without tracking
+	 * which ballots they come from (see Election::set_count_only).
+	 *
+	 * @param num_threads The number of threads that decode the ballot files
+	 * and count the ballots, or `0` to use every hardware thread.
+	 *
+	 * @return A pointer to the new Election, or `nullptr` if the election
+	 * type is not recognized, the headers of the files do not match, or a
+	 * file has fewer ballots than its header declares.
+	 */
+	static Election* CreateElection(std::vector<std::string> filenames, std::string output_dir="", bool deduplicate=false, bool count_only=false, int num_threads=0);
+
+	/**
+	 * @brief Compile ballot files into a binary ballot file.
+	 *
+	 * The ballots of all files are decoded once and written, in order, to
+	 * a `.vbc` file (see VbcWriter) that can then be given to the voting
+	 * system in place of the CSV files.
+	 *
 	 * @param filenames A vector of ballot filenames.
 	 *
-	 * @return The aggregated data from the ballot files.
+	 * @param vbc_filename The name of the `.vbc` file to create.
+	 *
+	 * @return Whether the file was compiled successfully.
 	 */
-	static std::vector<std::vector<std::string>> AggregateData(std::vector<std::string> filenames);
+	static bool CompileBallotFile(std::vector<std::string> filenames, std::string vbc_filename);
 
 	/**
 	 * @brief Set the names of ballot files to be processed.
@@ -71,10 +135,121 @@ public:
 	 */
 	std::vector<std::string> get_filenames() { return filenames; }
 
+	/**
+	 * @brief Set whether identical ballots are counted once as a weighted group.
+	 *
+	 * @param d Whether to deduplicate ballots.
+	 */
+	void set_deduplicate(bool d) { deduplicate = d; }
+
+	/**
+	 * @brief Set whether votes are only counted, without tracking which ballots they come from.
+	 *
+	 * @param c Whether to only count votes.
+	 */
+	void set_count_only(bool c) { count_only = c; }
+
+	/**
+	 * @brief Set the number of threads that read and count the ballots.
+	 *
+	 * @param n The number of threads, or `0` to use every hardware thread.
+	 */
+	void set_num_threads(int n) { num_threads = n; }
+
 
 private:
+	/**
+	 * @brief Parse the header of a CSV ballot file.
+	 *
+	 * @param csv A reader positioned at the start of the ballot file. It is
+	 * left positioned at the first ballot row.
+	 *
+	 * @return The parsed header lines, in the same layout as CsvToData.
+	 */
+	static std::vector<std::vector<std::string>> ReadHeader(CsvReader& csv);
+
+	/**
+	 * @brief Parse and combine the headers of ballot files.
+	 *
+	 * @param filenames A vector of ballot filenames, in CSV or `.vbc` format.
+	 *
+	 * @return The header of the first file with the number of ballots
+	 * summed over all files, or an empty vector if a header cannot be read
+	 * or the headers do not match.
+	 */
+	static std::vector<std::vector<std::string>> ReadHeaders(const std::vector<std::string>& filenames);
+
+	/**
+	 * @brief Decode the ballots of ballot files and add them to an election.
+	 *
+	 * The ballot rows of each CSV file are split into newline-aligned
+	 * chunks, which are decoded concurrently a round of one chunk per
+	 * thread at a time, so a single large file is decoded on every thread
+	 * and several small files are decoded at once. The ballots are added
+	 * in file and row order, so ballot IDs are the same as reading the
+	 * files one after another. Compiled `.vbc` files are streamed in as
+	 * they are read.
+	 *
+	 * @param election The election to add the ballots to.
+	 *
+	 * @param filenames A vector of ballot filenames.
+	 *
+	 * @param num_threads The number of threads that decode the ballot rows,
+	 * or `0` to use every hardware thread.
+	 *
+	 * @return Whether every file had as many ballots as its header declares.
+	 */
+	static bool AddBallots(Election* election, const std::vector<std::string>& filenames, int num_threads);
+
+	/**
+	 * @brief Check the number of ballots read from a file against its header.
+	 *
+	 * @param filename The name of the ballot file.
+	 *
+	 * @param rows The number of ballots read from the file.
+	 *
+	 * @param declared The number of ballots declared in the file's header.
+	 *
+	 * @return Whether the file has as many ballots as it declares.
+	 */
+	static bool CheckBallotCount(const std::string& filename, int rows, int declared);
+
+	/**
+	 * @brief Return whether a ballot file is a compiled `.vbc` file.
+	 *
+	 * @param filename The name of the ballot file.
+	 */
+	static bool IsCompiled(const std::string& filename);
+
+	/**
+	 * @brief Return the number of header lines for an election type.
+	 *
+	 * @param type The election type on the first line of the ballot file.
+	 */
+	static int HeaderLength(const std::string& type);
+
+	/**
+	 * @brief Check that two ballot files belong to the same election.
+	 *
+	 * @param first The parsed data (or header) of the first ballot file.
+	 *
+	 * @param other The parsed data (or header) of another ballot file.
+	 *
+	 * @return Whether the election type, candidates and number of seats match.
+	 */
+	static bool HeadersMatch(const std::vector<std::vector<std::string>>& first, const std::vector<std::vector<std::string>>& other);
+
 	/// Names of the ballot file.
 	std::vector<std::string> filenames;
+
+	/// Whether identical ballots are counted once as a weighted group.
+	bool deduplicate{false};
+
+	/// Whether votes are only counted, without tracking which ballots they come from.
+	bool count_only{false};
+
+	/// The number of threads that read and count the ballots, or `0` to use every hardware thread.
+	int num_threads{0};
 };
 
 #endif
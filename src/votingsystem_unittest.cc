@@ -8,8 +8,12 @@
 
 #include <string>
 #include <vector>
+#include <fstream>
+#include <cstdio>
 #include "gtest/gtest.h"
 #include "votingsystem.h"
+#include "oplelection.h"
+#include "test_ballot_rows.h"
 
 /// Test fixture for testing the VotingSystem class.
 class VotingSystemTest: public ::testing::Test {
@@ -25,6 +29,17 @@ public:
 	}
 
 protected:
+	/// Expect two elections to hold the same ballots in the same order.
+	void ExpectSameBallots(Election* expected, Election* actual) {
+		ASSERT_EQ(actual->get_ballots().size(), expected->get_ballots().size());
+		std::vector<uint16_t> expected_choices, actual_choices;
+		for (int i = 0; i < expected->get_ballots().size(); i++) {
+			expected->get_ballots().GetChoices(i, expected_choices);
+			actual->get_ballots().GetChoices(i, actual_choices);
+			EXPECT_EQ(actual_choices, expected_choices);
+		}
+	}
+
 	/// A pointer to a VotingSystem instace.
 	VotingSystem* vs;
 };
@@ -283,3 +298,235 @@ TEST_F (VotingSystemTest, VotingSystemAggregateData) {
 	EXPECT_EQ(po_data[12][1], "1");
 }
 
+
+/// Test the functionality of VotingSystem's CreateElection method.
+TEST_F (VotingSystemTest, VotingSystemCreateElection) {
+	std::vector<std::string> ir_filenames{"../testing/ir_testfile_part1.csv", "../testing/ir_testfile_part2.csv"};
+	Election* ir = VotingSystem::CreateElection(ir_filenames, "../testing/");
+	ASSERT_NE(ir, nullptr);
+	EXPECT_EQ(ir->get_total_candidates(), 4);
+	EXPECT_EQ(ir->get_total_ballots(), 6);
+	EXPECT_EQ(ir->get_candidate(3).get_name(), "Royce");
+	delete ir;
+
+	std::vector<std::string> opl_filenames{"../testing/opl_testfile_part1.csv", "../testing/opl_testfile_part2.csv", "../testing/opl_testfile_part3.csv"};
+	OPLElection* opl = static_cast<OPLElection*>(VotingSystem::CreateElection(opl_filenames, "../testing/"));
+	ASSERT_NE(opl, nullptr);
+	EXPECT_EQ(opl->get_total_candidates(), 6);
+	EXPECT_EQ(opl->get_total_seats(), 3);
+	EXPECT_EQ(opl->get_total_ballots(), 9);
+
+	opl->DistributeBallots();
+	ExpectVotes(opl, {3, 2, 0, 2, 1, 1});
+	delete opl;
+
+	std::vector<std::string> missing{"../testing/does_not_exist.csv"};
+	EXPECT_EQ(VotingSystem::CreateElection(missing, "../testing/"), nullptr);
+}
+
+/// Test that CreateElection skips blank lines and checks the number of ballots against the header.
+TEST_F (VotingSystemTest, VotingSystemCreateElectionRowCount) {
+	std::string rows = "1,,,\n\n,1,,\n\n1,,,\n,,1,\n\n\n";
+	std::ofstream("../testing/po_testfile_rowcount.csv") << "PO\n4\n[A,D],[B,R],[C,I],[D,L]\n3\n" << rows;
+
+	// Blank lines are not ballots, and rows beyond the header's count are ignored
+	Election* po = VotingSystem::CreateElection({"../testing/po_testfile_rowcount.csv"}, "../testing/");
+	ASSERT_NE(po, nullptr);
+	po->Run();
+	ExpectVotes(po, {2, 1, 0, 0});
+	delete po;
+
+	// A file with fewer ballots than its header declares is rejected
+	std::ofstream("../testing/po_testfile_rowcount.csv") << "PO\n4\n[A,D],[B,R],[C,I],[D,L]\n5\n" << rows;
+	EXPECT_EQ(VotingSystem::CreateElection({"../testing/po_testfile_rowcount.csv"}, "../testing/"), nullptr);
+	std::remove("../testing/po_testfile_rowcount.csv");
+}
+
+/// Test that CreateElection counts ballots that repeat or skip a rank as far as their ranks go.
+TEST_F (VotingSystemTest, VotingSystemCreateElectionRankErrors) {
+	std::ofstream("../testing/ir_testfile_rankerrors.csv") << "IR\n4\nRosen (D),Kleinberg (R),Chou (I),Royce (L)\n3\n1,1,2,3\n1,2,3,4\n2,1,4,\n";
+	for (bool count_only : {false, true}) {
+		Election* ir = VotingSystem::CreateElection({"../testing/ir_testfile_rankerrors.csv"}, "../testing/", false, count_only);
+		ASSERT_NE(ir, nullptr);
+		EXPECT_EQ(ir->get_total_rank_errors(), 2);
+		if (!count_only) {
+			std::vector<uint16_t> choices;
+			ir->get_ballots().GetChoices(0, choices);
+			EXPECT_EQ(choices, std::vector<uint16_t>({0, 2, 3}));
+			ir->get_ballots().GetChoices(2, choices);
+			EXPECT_EQ(choices, std::vector<uint16_t>({1, 0}));
+		}
+		delete ir;
+	}
+	std::remove("../testing/ir_testfile_rankerrors.csv");
+}
+
+/// Test that CreateElection adds the ballots of concurrently decoded files in file order.
+TEST_F (VotingSystemTest, VotingSystemCreateElectionThreads) {
+	std::vector<std::string> opl_filenames{"../testing/opl_testfile_part1.csv", "../testing/opl_testfile_part2.csv", "../testing/opl_testfile_part3.csv"};
+	Election* sequential = VotingSystem::CreateElection(opl_filenames, "../testing/", false, false, 1);
+	ASSERT_NE(sequential, nullptr);
+	EXPECT_EQ(sequential->get_ballots().size(), 9);
+	for (int threads = 2; threads <= 4; threads++) {
+		Election* concurrent = VotingSystem::CreateElection(opl_filenames, "../testing/", false, false, threads);
+		ASSERT_NE(concurrent, nullptr);
+		ExpectSameBallots(sequential, concurrent);
+		delete concurrent;
+	}
+	Election* whole = VotingSystem::CreateElection({"../testing/opl_testfile.csv"}, "../testing/", false, false, 1);
+	ExpectSameBallots(whole, sequential);
+	delete whole;
+	delete sequential;
+}
+
+/// Test that CreateElection splits a large file into chunks and adds their ballots in row order.
+TEST_F (VotingSystemTest, VotingSystemCreateElectionChunks) {
+	// More than a megabyte of ballot rows, with blank lines between some of them
+	const int total_ballots = 200000;
+	const char* rankings[] = {"1,2,3,4", "4,1,2,3", "3,4,1,2", "2,3,4,1", ",,1,2"};
+	{
+		std::ofstream file("../testing/ir_testfile_large.csv");
+		file << "IR\n4\nRosen (D),Kleinberg (R),Chou (I),Royce (L)\n" << total_ballots << "\n";
+		for (int i = 0; i < total_ballots; i++) {
+			file << rankings[i % 5] << "\n" << (i % 1000 == 0 ? "\n" : "");
+		}
+	}
+
+	Election* sequential = VotingSystem::CreateElection({"../testing/ir_testfile_large.csv"}, "../testing/", false, false, 1);
+	ASSERT_NE(sequential, nullptr);
+	ASSERT_EQ(sequential->get_ballots().size(), total_ballots);
+	std::vector<uint16_t> choices;
+	sequential->get_ballots().GetChoices(total_ballots - 1, choices);
+	EXPECT_EQ(choices, std::vector<uint16_t>({2, 3}));
+	for (int threads = 2; threads <= 4; threads++) {
+		Election* chunked = VotingSystem::CreateElection({"../testing/ir_testfile_large.csv"}, "../testing/", false, false, threads);
+		ASSERT_NE(chunked, nullptr);
+		ExpectSameBallots(sequential, chunked);
+		delete chunked;
+	}
+	delete sequential;
+	std::remove("../testing/ir_testfile_large.csv");
+}
+
+/// Test that an election counts the same votes when identical ballots are grouped.
+TEST_F (VotingSystemTest, VotingSystemCreateElectionDeduplicate) {
+	std::vector<std::string> opl_filenames{"../testing/opl_testfile_part1.csv", "../testing/opl_testfile_part2.csv", "../testing/opl_testfile_part3.csv"};
+	OPLElection* opl = static_cast<OPLElection*>(VotingSystem::CreateElection(opl_filenames, "../testing/", true));
+	ASSERT_NE(opl, nullptr);
+	EXPECT_EQ(opl->get_total_ballots(), 9);
+
+	opl->DistributeBallots();
+	ExpectVotes(opl, {3, 2, 0, 2, 1, 1});
+	int party_votes = 0;
+	for (int i = 0; i < opl->get_total_parties(); i++) {
+		party_votes += opl->get_party(i).get_total_votes();
+	}
+	EXPECT_EQ(party_votes, 9);
+	delete opl;
+
+	Election* ir = VotingSystem::CreateElection({"../testing/ir_testfile.csv"}, "../testing/", true);
+	ASSERT_NE(ir, nullptr);
+	ir->Run();
+	EXPECT_TRUE(ir->is_winner(0));
+	delete ir;
+}
+
+/// Test that PO and OPL elections count the same votes when ballots are counted as they are read.
+TEST_F (VotingSystemTest, VotingSystemCreateElectionCountOnly) {
+	std::vector<std::string> opl_filenames{"../testing/opl_testfile_part1.csv", "../testing/opl_testfile_part2.csv", "../testing/opl_testfile_part3.csv"};
+	OPLElection* opl = static_cast<OPLElection*>(VotingSystem::CreateElection(opl_filenames, "../testing/", false, true));
+	ASSERT_NE(opl, nullptr);
+	opl->DistributeBallots();
+	ExpectVotes(opl, {3, 2, 0, 2, 1, 1});
+	delete opl;
+
+	Election* po = VotingSystem::CreateElection({"../testing/po_testfile.csv"}, "../testing/", false, true);
+	ASSERT_NE(po, nullptr);
+	po->Run();
+	ExpectVotes(po, {3, 2, 0, 2, 1, 1});
+	EXPECT_TRUE(po->is_winner(0));
+	delete po;
+}
+
+/// Test that AggregateData gives the same result on any number of threads and rejects mismatched headers.
+TEST_F (VotingSystemTest, VotingSystemAggregateDataThreads) {
+	std::vector<std::string> opl_filenames{"../testing/opl_testfile_part1.csv", "../testing/opl_testfile_part2.csv", "../testing/opl_testfile_part3.csv"};
+	std::vector<std::vector<std::string>> sequential = VotingSystem::AggregateData(opl_filenames, 1);
+	for (int threads = 2; threads <= 4; threads++) {
+		EXPECT_EQ(VotingSystem::AggregateData(opl_filenames, threads), sequential);
+	}
+	EXPECT_EQ(sequential, VotingSystem::CsvToData("../testing/opl_testfile.csv"));
+
+	std::vector<std::string> mixed_filenames{"../testing/ir_testfile.csv", "../testing/opl_testfile.csv"};
+	EXPECT_TRUE(VotingSystem::AggregateData(mixed_filenames).empty());
+	EXPECT_EQ(VotingSystem::CreateElection(mixed_filenames, "../testing/"), nullptr);
+}
+
+/// Test that CsvToData gives the same result when a file is split across threads.
+TEST_F (VotingSystemTest, VotingSystemCsvToDataThreads) {
+	std::vector<std::string> files{"../testing/ir_testfile.csv", "../testing/opl_testfile.csv", "../testing/po_testfile.csv", "../testing/po_testfile_zerovote.csv"};
+	for (const auto& file : files) {
+		std::vector<std::vector<std::string>> sequential = VotingSystem::CsvToData(file, 1);
+		for (int threads = 2; threads <= 8; threads++) {
+			EXPECT_EQ(VotingSystem::CsvToData(file, threads), sequential);
+		}
+	}
+}
+
+/// Test the functionality of VotingSystem's CompileBallotFile method.
+TEST_F (VotingSystemTest, VotingSystemCompileBallotFile) {
+	std::vector<std::string> ir_filenames{"../testing/ir_testfile_part1.csv", "../testing/ir_testfile_part2.csv"};
+	ASSERT_TRUE(VotingSystem::CompileBallotFile(ir_filenames, "../testing/ir_testfile_compiled.vbc"));
+	EXPECT_TRUE(vs->ValidateFileName("../testing/ir_testfile_compiled.vbc"));
+
+	// The compiled file loads the same election as the CSV file
+	Election* csv = VotingSystem::CreateElection({"../testing/ir_testfile.csv"}, "../testing/");
+	Election* vbc = VotingSystem::CreateElection({"../testing/ir_testfile_compiled.vbc"}, "../testing/");
+	ASSERT_NE(vbc, nullptr);
+	EXPECT_EQ(vbc->get_total_candidates(), csv->get_total_candidates());
+	EXPECT_EQ(vbc->get_total_ballots(), csv->get_total_ballots());
+	for (int i = 0; i < csv->get_total_candidates(); i++) {
+		EXPECT_EQ(vbc->get_candidate(i).get_name(), csv->get_candidate(i).get_name());
+		EXPECT_EQ(vbc->get_candidate(i).get_party(), csv->get_candidate(i).get_party());
+	}
+	ExpectSameBallots(csv, vbc);
+	csv->Run();
+	vbc->Run();
+	for (int i = 0; i < csv->get_total_candidates(); i++) {
+		EXPECT_EQ(vbc->get_candidate(i).get_total_votes(), csv->get_candidate(i).get_total_votes());
+		EXPECT_EQ(vbc->is_winner(i), csv->is_winner(i));
+	}
+	delete csv;
+	delete vbc;
+
+	std::vector<std::string> opl_filenames{"../testing/opl_testfile_part1.csv", "../testing/opl_testfile_part2.csv", "../testing/opl_testfile_part3.csv"};
+	ASSERT_TRUE(VotingSystem::CompileBallotFile(opl_filenames, "../testing/opl_testfile_compiled.vbc"));
+	OPLElection* opl = static_cast<OPLElection*>(VotingSystem::CreateElection({"../testing/opl_testfile_compiled.vbc"}, "../testing/"));
+	ASSERT_NE(opl, nullptr);
+	EXPECT_EQ(opl->get_total_seats(), 3);
+	EXPECT_EQ(opl->get_total_ballots(), 9);
+	Election* opl_csv = VotingSystem::CreateElection({"../testing/opl_testfile.csv"}, "../testing/");
+	ASSERT_NE(opl_csv, nullptr);
+	ExpectSameBallots(opl_csv, opl);
+	delete opl_csv;
+
+	opl->DistributeBallots();
+	ExpectVotes(opl, {3, 2, 0, 2, 1, 1});
+	delete opl;
+
+	std::remove("../testing/ir_testfile_compiled.vbc");
+	std::remove("../testing/opl_testfile_compiled.vbc");
+}
+
+/// Test that a corrupt compiled ballot file is reported instead of loading fewer ballots.
+TEST_F (VotingSystemTest, VotingSystemCreateElectionCorruptVbc) {
+	std::vector<std::string> opl_filenames{"../testing/opl_testfile_part1.csv", "../testing/opl_testfile_part2.csv", "../testing/opl_testfile_part3.csv"};
+	ASSERT_TRUE(VotingSystem::CompileBallotFile(opl_filenames, "../testing/opl_testfile_corrupt.vbc"));
+
+	// The last choice of the last ballot names a candidate that does not exist
+	std::fstream("../testing/opl_testfile_corrupt.vbc", std::ios::in | std::ios::out | std::ios::binary).seekp(-1, std::ios::end).put(9);
+	EXPECT_EQ(VotingSystem::CreateElection({"../testing/opl_testfile_corrupt.vbc"}, "../testing/"), nullptr);
+	EXPECT_FALSE(VotingSystem::CompileBallotFile({"../testing/opl_testfile_corrupt.vbc"}, "../testing/opl_testfile_recompiled.vbc"));
+	EXPECT_FALSE(vs->ValidateFileName("../testing/opl_testfile_recompiled.vbc"));
+	std::remove("../testing/opl_testfile_corrupt.vbc");
+}